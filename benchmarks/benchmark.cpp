@@ -0,0 +1,803 @@
+#include <string.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Project includes
+#include <FactorGraph.hpp>
+#include <Generator.hpp>
+#include <Memory.hpp>
+#include <Solver.hpp>
+
+using namespace sat;
+using namespace std;
+
+// -----------------------------------------------------------------------------
+// Struct to save benchmark parameters
+// -----------------------------------------------------------------------------
+struct BenchmarkArgs {
+  vector<int> N = {1000, 10000, 100000};
+  vector<double> a = {4.2};
+  int reps = 5;
+  unsigned int s = 7357;
+
+  // Scaling mode
+  bool scaling = false;
+  double f = 0.01;
+  string baseline = "";      // Baseline file to compare with
+  string saveBaseline = "";  // File to store the results as new baseline
+  double tolerance = 0.2;    // Allowed relative increase over the baseline
+
+  // Sweep orders mode
+  bool orders = false;
+
+  // Acceleration mode
+  bool acceleration = false;
+  vector<int> depths = {0, 2, 3, 5};  // Anderson depths to compare
+  SweepOrder sweepOrder = SWEEP_SHUFFLE;  // Order used by the other modes
+
+  GraphOrder graphOrder = ORDER_DIMACS;  // Storage order of the graphs
+  int threads = 1;                       // Threads of the solver
+};
+
+// -----------------------------------------------------------------------------
+// Struct to save the result of a benchmark
+// ops: number of measured operations (edges, variables, flips...)
+// -----------------------------------------------------------------------------
+struct BenchmarkResult {
+  string name;
+  string unit;
+  double ops = 0;
+  double ns = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Struct to save the result of a SID run in scaling mode
+// -----------------------------------------------------------------------------
+struct ScalingResult {
+  int N;
+  double a;
+  double f;
+  string result;
+  double timeMs;
+  int spIterations;
+  long peakRSS;  // KB
+};
+
+// -----------------------------------------------------------------------------
+// Struct to save the result of full SP runs with a sweep order
+// -----------------------------------------------------------------------------
+struct OrderResult {
+  SweepOrder order;
+  int runs = 0;
+  int converged = 0;
+  double iterations = 0;
+  double edgeUpdates = 0;
+  double ns = 0;
+  double extrapolations = 0;  // Anderson steps kept
+  double fallbacks = 0;       // Anderson steps reverted
+};
+
+// -----------------------------------------------------------------------------
+// Elapsed nanoseconds since begin
+// -----------------------------------------------------------------------------
+double elapsedNs(chrono::steady_clock::time_point begin) {
+  chrono::steady_clock::time_point end = chrono::steady_clock::now();
+  return chrono::duration_cast<chrono::nanoseconds>(end - begin).count();
+}
+
+// -----------------------------------------------------------------------------
+// Silence the standard output during the lifetime of the object, so the
+// messages of the solver don't break the results table
+// -----------------------------------------------------------------------------
+struct QuietOutput {
+  streambuf* buffer;
+  QuietOutput() : buffer(cout.rdbuf(nullptr)) {}
+  ~QuietOutput() { cout.rdbuf(buffer); }
+};
+
+namespace sat {
+
+// =============================================================================
+// SolverBenchmark
+//
+// Measure the hot paths of the Solver in isolation. Every benchmark runs
+// the step reps times and returns the total time and measured operations.
+// =============================================================================
+class SolverBenchmark {
+ public:
+  // ---------------------------------------------------------------------------
+  // DIMACS parse (ns per edge)
+  // ---------------------------------------------------------------------------
+  static BenchmarkResult parse(const string& dimacs, GraphOrder order,
+                               int reps) {
+    BenchmarkResult result = {"parse", "edge"};
+    for (int r = 0; r < reps; r++) {
+      istringstream stream(dimacs);
+      chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+      FactorGraph* graph = new FactorGraph(stream, order);
+      result.ns += elapsedNs(begin);
+      result.ops += graph->edges.size();
+      delete graph;
+    }
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+  // FactorGraph clone (ns per edge)
+  // ---------------------------------------------------------------------------
+  static BenchmarkResult clone(FactorGraph* graph, int reps) {
+    BenchmarkResult result = {"clone", "edge"};
+    for (int r = 0; r < reps; r++) {
+      chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+      FactorGraph* clone = graph->Clone();
+      result.ns += elapsedNs(begin);
+      result.ops += clone->edges.size();
+      delete clone;
+    }
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+  // computeSubProducts (ns per edge)
+  // ---------------------------------------------------------------------------
+  static BenchmarkResult subProducts(Solver& solver, FactorGraph* graph,
+                                     int reps) {
+    BenchmarkResult result = {"subproducts", "edge"};
+    prepareSurveys(solver, graph);
+    for (int r = 0; r < reps; r++) {
+      chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+      solver.computeSubProducts();
+      result.ns += elapsedNs(begin);
+      result.ops += graph->edges.size();
+    }
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+  // One full SP sweep over all clauses (ns per edge-update)
+  // ---------------------------------------------------------------------------
+  static BenchmarkResult sweep(Solver& solver, FactorGraph* graph, int reps) {
+    BenchmarkResult result = {"sp_sweep", "edge-update"};
+    prepareSurveys(solver, graph);
+    solver.computeSubProducts();
+    unsigned arity = Solver::clauseArity(graph->clauses);
+    for (int r = 0; r < reps; r++) {
+      chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+      solver.sweepSurveys(graph->clauses, arity);
+      result.ns += elapsedNs(begin);
+      result.ops += graph->edges.size();
+    }
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Full SP from random surveys until convergence or spMaxIt iterations with
+  // the sweep order of the solver (iterations, time and ns per edge-update)
+  // ---------------------------------------------------------------------------
+  static OrderResult surveyPropagation(Solver& solver, FactorGraph* graph,
+                                       int reps) {
+    OrderResult result;
+    result.order = solver.sweepOrder;
+    for (int r = 0; r < reps; r++) {
+      prepareSurveys(solver, graph);
+      solver.totalSPIterations = 0;
+
+      solver.totalSPExtrapolations = 0;
+      solver.totalSPFallbacks = 0;
+
+      chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+      AlgorithmResult spResult = solver.surveyPropagation();
+      result.ns += elapsedNs(begin);
+
+      result.runs++;
+      if (spResult == CONVERGE) result.converged++;
+      result.iterations += solver.totalSPIterations;
+      result.edgeUpdates +=
+          (double)solver.totalSPIterations * graph->edges.size();
+      result.extrapolations += solver.totalSPExtrapolations;
+      result.fallbacks += solver.totalSPFallbacks;
+    }
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Decimation step: evaluate, sort and fix 1% of the variables after a few
+  // SP sweeps (ns per evaluated variable)
+  // ---------------------------------------------------------------------------
+  static BenchmarkResult decimation(Solver& solver, FactorGraph* graph,
+                                    int reps) {
+    BenchmarkResult result = {"decimation", "variable"};
+    double paramagneticState = solver.paramagneticState;
+    solver.paramagneticState = 0.0;  // Never call walksat
+    for (int r = 0; r < reps; r++) {
+      graph->Reset();
+      prepareSurveys(solver, graph);
+      solver.computeSubProducts();
+      unsigned arity = Solver::clauseArity(graph->clauses);
+      for (int i = 0; i < 5; i++) solver.sweepSurveys(graph->clauses, arity);
+
+      QuietOutput quiet;
+      chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+      solver.decimate(graph->variables.size() / 100);
+      result.ns += elapsedNs(begin);
+      result.ops += graph->variables.size();
+    }
+    solver.paramagneticState = paramagneticState;
+    graph->Reset();
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Unit propagation cascades: assign all variables of a planted instance to
+  // the planted solution in random order (ns per assigned variable, either
+  // assigned directly or by UP)
+  // ---------------------------------------------------------------------------
+  static BenchmarkResult unitPropagation(Solver& solver, FactorGraph* graph,
+                                         const vector<bool>& solution,
+                                         int reps) {
+    BenchmarkResult result = {"unit_propagation", "variable"};
+    vector<Variable*> order = graph->variables;
+    for (int r = 0; r < reps; r++) {
+      graph->Reset();
+      solver.fg = graph;
+      Shuffle(order.begin(), order.end(), solver.randomGenerator);
+
+      chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+      for (Variable* var : order) {
+        if (!var->assigned) solver.assignVariable(var, solution[var->id - 1]);
+      }
+      result.ns += elapsedNs(begin);
+      result.ops += graph->variables.size();
+    }
+    graph->Reset();
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+  // WalkSAT flips over the whole formula (ns per flip)
+  // ---------------------------------------------------------------------------
+  static BenchmarkResult walksat(Solver& solver, FactorGraph* graph,
+                                 int reps) {
+    BenchmarkResult result = {"walksat", "flip"};
+    int wsMaxTries = solver.wsMaxTries;
+    int wsMaxFlips = solver.wsMaxFlips;
+    solver.wsMaxTries = 1;
+    solver.wsMaxFlips = 10 * graph->variables.size();
+    for (int r = 0; r < reps; r++) {
+      graph->Reset();
+      solver.fg = graph;
+      solver.totalWSFlips = 0;
+
+      QuietOutput quiet;
+      chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+      solver.walksat();
+      result.ns += elapsedNs(begin);
+      result.ops += solver.totalWSFlips;
+    }
+    solver.wsMaxTries = wsMaxTries;
+    solver.wsMaxFlips = wsMaxFlips;
+    graph->Reset();
+    return result;
+  }
+
+ private:
+  static void prepareSurveys(Solver& solver, FactorGraph* graph) {
+    solver.fg = graph;
+    for (Edge* edge : graph->edges) edge->survey = solver.getRandomReal01();
+  }
+};
+
+}  // namespace sat
+
+// -----------------------------------------------------------------------------
+// Print a result row
+// -----------------------------------------------------------------------------
+void printResult(int N, const BenchmarkResult& result) {
+  double nsPerOp = result.ops > 0 ? result.ns / result.ops : 0;
+  double opsPerSecond = result.ns > 0 ? result.ops * 1.0e9 / result.ns : 0;
+  cout << left << setw(18) << result.name << right << setw(9) << N
+       << setw(13) << (long long)result.ops << setw(12) << fixed
+       << setprecision(2) << nsPerOp << "  ns/" << left << setw(13)
+       << result.unit << right << setw(14) << setprecision(0) << opsPerSecond
+       << " " << result.unit << "/s" << endl;
+}
+
+// -----------------------------------------------------------------------------
+// Print a result row of the sweep orders mode
+// -----------------------------------------------------------------------------
+void printOrderResult(int N, double a, const OrderResult& result) {
+  double nsPerUpdate = result.edgeUpdates > 0 ? result.ns / result.edgeUpdates
+                                              : 0;
+  cout << left << setw(14) << Solver::SweepOrderName(result.order) << right
+       << setw(9) << N << setw(6) << a << setw(8) << result.converged << "/"
+       << left << setw(5)
+       << result.runs << right << setw(12) << fixed << setprecision(1)
+       << result.iterations / result.runs << setw(14)
+       << result.ns / result.runs / 1.0e6 << setw(14) << setprecision(2)
+       << nsPerUpdate << endl;
+  cout << defaultfloat << setprecision(6);
+}
+
+// -----------------------------------------------------------------------------
+// Run SID on a random instance of the grid
+// Peak memory is measured during SID, without the DIMACS text of the instance
+// -----------------------------------------------------------------------------
+ScalingResult runScaling(int N, double a, BenchmarkArgs* args) {
+  ScalingResult scalingResult = {N, a, args->f};
+
+  FactorGraph* graph;
+  {
+    Generator generator(args->s + N);
+    ostringstream dimacs;
+    generator.RandomKSAT(dimacs, N, N * a, 3);
+    istringstream stream(dimacs.str());
+    graph = new FactorGraph(stream, args->graphOrder);
+  }
+  ResetPeakRSS();
+
+  Solver solver(N, a, args->s);
+  solver.sweepOrder = args->sweepOrder;
+  solver.threads = args->threads;
+  AlgorithmResult result;
+  chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+  {
+    QuietOutput quiet;
+    result = solver.SID(graph, args->f);
+  }
+  scalingResult.timeMs = elapsedNs(begin) / 1.0e6;
+
+  scalingResult.spIterations = solver.totalSPIterations;
+  scalingResult.peakRSS = GetPeakRSS();
+  scalingResult.result = Solver::ResultName(result);
+
+  delete graph;
+  return scalingResult;
+}
+
+// -----------------------------------------------------------------------------
+// Baseline files
+// CSV: N,a,f,result,time_ms,sp_iterations,peak_rss_kb
+// -----------------------------------------------------------------------------
+bool storeBaseline(const string& path, const vector<ScalingResult>& results) {
+  ofstream file(path);
+  if (!file.is_open()) return false;
+
+  file << "N,a,f,result,time_ms,sp_iterations,peak_rss_kb\n";
+  for (const ScalingResult& r : results) {
+    file << r.N << "," << r.a << "," << r.f << "," << r.result << ","
+         << r.timeMs << "," << r.spIterations << "," << r.peakRSS << "\n";
+  }
+  return true;
+}
+
+vector<ScalingResult> readBaseline(const string& path) {
+  vector<ScalingResult> results;
+  ifstream file(path);
+  if (!file.is_open()) {
+    cerr << "ERROR: Can't open baseline file " << path << endl;
+    exit(-1);
+  }
+
+  string line;
+  int row = 1;
+  getline(file, line);  // Header
+  while (getline(file, line)) {
+    row++;
+    if (line.empty()) continue;
+    vector<string> tokens;
+    stringstream stream(line);
+    string token;
+    while (getline(stream, token, ',')) tokens.push_back(token);
+
+    if (tokens.size() != 7) {
+      cerr << "ERROR: Line " << row << " of baseline file " << path
+           << " has " << tokens.size() << " fields instead of 7" << endl;
+      exit(-1);
+    }
+    try {
+      results.push_back({stoi(tokens[0]), stod(tokens[1]), stod(tokens[2]),
+                         tokens[3], stod(tokens[4]), stoi(tokens[5]),
+                         stol(tokens[6])});
+    } catch (const exception&) {
+      cerr << "ERROR: Line " << row << " of baseline file " << path
+           << " has a field that isn't a number" << endl;
+      exit(-1);
+    }
+  }
+  return results;
+}
+
+// -----------------------------------------------------------------------------
+// Compare a result with its baseline. Time, SP iterations and peak memory
+// can't exceed the baseline more than the tolerance, and a SAT instance of
+// the baseline must be still SAT. Time differences below 10ms are ignored as
+// noise. Returns the number of regressions found
+// -----------------------------------------------------------------------------
+int compareWithBaseline(const ScalingResult& r, const ScalingResult& base,
+                        double tolerance) {
+  int regressions = 0;
+  auto check = [&](const string& metric, double value, double baseValue,
+                   double slack) {
+    if (value > baseValue * (1 + tolerance) + slack) {
+      cout << "REGRESSION [" << r.N << " - " << r.a << "]: " << metric << " "
+           << value << " (baseline " << baseValue << ")" << endl;
+      regressions++;
+    }
+  };
+
+  check("time (ms)", r.timeMs, base.timeMs, 10.0);
+  check("SP iterations", r.spIterations, base.spIterations, 0);
+  check("peak memory (KB)", r.peakRSS, base.peakRSS, 0);
+  if (base.result == "SAT" && r.result != "SAT") {
+    cout << "REGRESSION [" << r.N << " - " << r.a << "]: result " << r.result
+         << " (baseline SAT)" << endl;
+    regressions++;
+  }
+  return regressions;
+}
+
+// -----------------------------------------------------------------------------
+// Scaling mode: run SID over the grid N x α and compare with the baseline
+// -----------------------------------------------------------------------------
+int scaling(BenchmarkArgs* args) {
+  cout << left << setw(10) << "N" << setw(8) << "a" << setw(15) << "result"
+       << right << setw(12) << "time (ms)" << setw(10) << "SP it."
+       << setw(14) << "peak (KB)" << endl;
+
+  vector<ScalingResult> results;
+  for (int N : args->N) {
+    for (double a : args->a) {
+      ScalingResult r = runScaling(N, a, args);
+      results.push_back(r);
+      cout << left << setw(10) << r.N << setw(8) << r.a << setw(15) << r.result
+           << right << setw(12) << fixed << setprecision(1) << r.timeMs
+           << setw(10) << r.spIterations << setw(14) << r.peakRSS << endl;
+      cout << defaultfloat << setprecision(6);
+    }
+  }
+
+  if (!args->saveBaseline.empty()) {
+    if (!storeBaseline(args->saveBaseline, results)) {
+      cerr << "ERROR: Can't store baseline file " << args->saveBaseline
+           << endl;
+      return -1;
+    }
+    cout << "Baseline stored in " << args->saveBaseline << endl;
+  }
+
+  if (args->baseline.empty()) return 0;
+
+  // Compare every result with the baseline of the same grid point. A grid
+  // point without baseline can't be checked, so it fails the run. Baseline
+  // rows out of the grid are only reported, to allow running part of it
+  int regressions = 0;
+  int missing = 0;
+  vector<ScalingResult> baseline = readBaseline(args->baseline);
+  vector<bool> matched(baseline.size(), false);
+  for (const ScalingResult& r : results) {
+    bool found = false;
+    for (unsigned b = 0; b < baseline.size(); b++) {
+      const ScalingResult& base = baseline[b];
+      if (base.N == r.N && std::abs(base.a - r.a) < 1e-9 &&
+          std::abs(base.f - r.f) < 1e-9) {
+        regressions += compareWithBaseline(r, base, args->tolerance);
+        matched[b] = true;
+        found = true;
+      }
+    }
+    if (!found) {
+      cout << "MISSING [" << r.N << " - " << r.a << "]: no baseline with f "
+           << r.f << endl;
+      missing++;
+    }
+  }
+  for (unsigned b = 0; b < baseline.size(); b++) {
+    if (matched[b]) continue;
+    cout << "NOT RUN [" << baseline[b].N << " - " << baseline[b].a
+         << "]: baseline with f " << baseline[b].f << " out of the grid"
+         << endl;
+  }
+
+  cout << endl;
+  if (regressions || missing) {
+    cout << "FAILED: " << regressions << " regressions and " << missing
+         << " grid points without baseline found (tolerance "
+         << args->tolerance * 100 << "%)" << endl;
+    return 1;
+  }
+  cout << "PASSED: No regressions found (tolerance " << args->tolerance * 100
+       << "%)" << endl;
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Microbenchmarks mode: measure the hot paths over the grid N x α
+// -----------------------------------------------------------------------------
+int microbenchmarks(BenchmarkArgs* args) {
+  cout << left << setw(18) << "benchmark" << right << setw(9) << "N"
+       << setw(13) << "ops" << setw(12) << "time/op" << setw(33)
+       << "throughput" << endl;
+
+  for (int N : args->N) {
+    for (double a : args->a) {
+      int M = N * a;
+
+      // Random instance for SP and WalkSAT, planted instance (always SAT) for
+      // unit propagation
+      Generator generator(args->s + N);
+      ostringstream randomDimacs;
+      generator.RandomKSAT(randomDimacs, N, M, 3);
+      vector<bool> solution;
+      ostringstream plantedDimacs;
+      generator.PlantedKSAT(plantedDimacs, N, M, 3, solution);
+
+      istringstream randomStream(randomDimacs.str());
+      FactorGraph* graph = new FactorGraph(randomStream, args->graphOrder);
+      istringstream plantedStream(plantedDimacs.str());
+      FactorGraph* plantedGraph =
+          new FactorGraph(plantedStream, args->graphOrder);
+
+      Solver solver(N, a, args->s);
+      solver.sweepOrder = args->sweepOrder;
+      solver.threads = args->threads;
+
+      printResult(N, SolverBenchmark::parse(randomDimacs.str(),
+                                            args->graphOrder, args->reps));
+      printResult(N, SolverBenchmark::clone(graph, args->reps));
+      printResult(N, SolverBenchmark::subProducts(solver, graph, args->reps));
+      printResult(N, SolverBenchmark::sweep(solver, graph, args->reps));
+      printResult(N, SolverBenchmark::decimation(solver, graph, args->reps));
+      printResult(N, SolverBenchmark::unitPropagation(solver, plantedGraph,
+                                                      solution, args->reps));
+      printResult(N, SolverBenchmark::walksat(solver, graph, args->reps));
+
+      delete graph;
+      delete plantedGraph;
+    }
+  }
+
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Sweep orders mode: compare the convergence and time of full SP runs with
+// every sweep order. All the orders start from the same random surveys
+// -----------------------------------------------------------------------------
+int sweepOrders(BenchmarkArgs* args) {
+  cout << left << setw(14) << "order" << right << setw(9) << "N" << setw(6)
+       << "a" << setw(14) << "converged" << setw(12) << "SP it." << setw(14)
+       << "time (ms)" << setw(14) << "ns/update" << endl;
+
+  for (int N : args->N) {
+    for (double a : args->a) {
+      Generator generator(args->s + N);
+      ostringstream dimacs;
+      generator.RandomKSAT(dimacs, N, N * a, 3);
+      istringstream stream(dimacs.str());
+      FactorGraph* graph = new FactorGraph(stream, args->graphOrder);
+
+      for (int order = 0; order < TOTAL_SWEEP_ORDERS; order++) {
+        Solver solver(N, a, args->s);
+        solver.sweepOrder = (SweepOrder)order;
+        OrderResult result =
+            SolverBenchmark::surveyPropagation(solver, graph, args->reps);
+        printOrderResult(N, a, result);
+      }
+
+      delete graph;
+    }
+  }
+
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Acceleration mode: compare full SP runs with every Anderson depth (0 is the
+// plain SP). All the depths start from the same random surveys. Saved is the
+// difference of the average SP iterations with the first depth
+// -----------------------------------------------------------------------------
+int acceleration(BenchmarkArgs* args) {
+  cout << right << setw(6) << "depth" << setw(9) << "N" << setw(6) << "a"
+       << setw(14) << "converged" << setw(12) << "SP it." << setw(10)
+       << "saved" << setw(14) << "time (ms)" << setw(10) << "extrap."
+       << setw(10) << "fallback" << endl;
+
+  for (int N : args->N) {
+    for (double a : args->a) {
+      Generator generator(args->s + N);
+      ostringstream dimacs;
+      generator.RandomKSAT(dimacs, N, N * a, 3);
+      istringstream stream(dimacs.str());
+      FactorGraph* graph = new FactorGraph(stream, args->graphOrder);
+
+      double baseIterations = 0;
+      for (unsigned d = 0; d < args->depths.size(); d++) {
+        Solver solver(N, a, args->s);
+        solver.sweepOrder = args->sweepOrder;
+        solver.spAndersonDepth = args->depths[d];
+        OrderResult result =
+            SolverBenchmark::surveyPropagation(solver, graph, args->reps);
+
+        double iterations = result.iterations / result.runs;
+        if (d == 0) baseIterations = iterations;
+        cout << right << setw(6) << args->depths[d] << setw(9) << N << setw(6)
+             << a << setw(8) << result.converged << "/" << left << setw(5)
+             << result.runs << right << setw(12) << fixed << setprecision(1)
+             << iterations << setw(10) << baseIterations - iterations
+             << setw(14) << result.ns / result.runs / 1.0e6 << setw(10)
+             << result.extrapolations / result.runs << setw(10)
+             << result.fallbacks / result.runs << endl;
+        cout << defaultfloat << setprecision(6);
+      }
+
+      delete graph;
+    }
+  }
+
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Parse command line arguments
+// -----------------------------------------------------------------------------
+void printUsage() {
+  cout << "Usage:" << endl;
+  cout << "\t./benchmark [options]" << endl;
+  cout << "\t./benchmark --scaling [options]" << endl;
+  cout << "\t./benchmark --sweep-orders [options]" << endl;
+  cout << "\t./benchmark --acceleration [options]" << endl;
+  cout << "Options:" << endl;
+  cout << "\t--N=n1,n2,...       Number of variables of the instances" << endl;
+  cout << "\t--a=a1,a2,...       Clauses/variables ratios" << endl;
+  cout << "\t--reps=r            Repetitions of every microbenchmark" << endl;
+  cout << "\t--seed=s            Seed of the instances and the solver" << endl;
+  cout << "\t--sweep=order       SP sweep order (shuffle, block, permutations,"
+       << endl;
+  cout << "\t                    offset)" << endl;
+  cout << "\t--graph-order=order Storage order of the graphs (dimacs, rcm)"
+       << endl;
+  cout << "\t--threads=t         Threads of the solver" << endl;
+  cout << "Scaling options:" << endl;
+  cout << "\t--f=f               SID assignment fraction" << endl;
+  cout << "\t--baseline=file     Fail if results regress from the baseline"
+       << endl;
+  cout << "\t--save-baseline=file Store the results as a new baseline" << endl;
+  cout << "\t--tolerance=t       Allowed relative regression (0.2 = 20%)"
+       << endl;
+  cout << "Acceleration options:" << endl;
+  cout << "\t--depths=d1,d2,...  Anderson depths to compare (0 = plain SP)"
+       << endl;
+}
+
+template <typename T>
+vector<T> parseList(const string& value) {
+  vector<T> list;
+  stringstream stream(value);
+  T element;
+  while (stream >> element) {
+    list.push_back(element);
+    if (stream.peek() == ',') stream.ignore();
+  }
+  return list;
+}
+
+BenchmarkArgs* parseArgs(int argc, char* argv[]) {
+  BenchmarkArgs* args = new BenchmarkArgs();
+
+  for (int i = 1; i < argc; i++) {
+    string option = argv[i];
+    if (option == "--scaling") {
+      args->scaling = true;
+      continue;
+    }
+    if (option == "--sweep-orders") {
+      args->orders = true;
+      continue;
+    }
+    if (option == "--acceleration") {
+      args->acceleration = true;
+      continue;
+    }
+
+    size_t equal = option.find('=');
+    if (option.rfind("--", 0) != 0 || equal == string::npos) {
+      printUsage();
+      exit(-1);
+    }
+
+    string name = option.substr(2, equal - 2);
+    string value = option.substr(equal + 1);
+    if (name == "N") {
+      args->N = parseList<int>(value);
+    } else if (name == "a") {
+      args->a = parseList<double>(value);
+    } else if (name == "reps") {
+      args->reps = stoi(value);
+    } else if (name == "seed") {
+      args->s = stoul(value);
+    } else if (name == "sweep" &&
+               Solver::ParseSweepOrder(value, args->sweepOrder)) {
+      // Order stored by ParseSweepOrder
+    } else if (name == "graph-order" &&
+               FactorGraph::ParseGraphOrder(value, args->graphOrder)) {
+      // Order stored by ParseGraphOrder
+    } else if (name == "threads" && stoi(value) > 0) {
+      args->threads = stoi(value);
+    } else if (name == "depths") {
+      args->depths = parseList<int>(value);
+    } else if (name == "f") {
+      args->f = stod(value);
+    } else if (name == "baseline") {
+      args->baseline = value;
+    } else if (name == "save-baseline") {
+      args->saveBaseline = value;
+    } else if (name == "tolerance") {
+      args->tolerance = stod(value);
+    } else {
+      printUsage();
+      exit(-1);
+    }
+  }
+
+  return args;
+}
+
+// Entry point
+int main(int argc, char* argv[]) {
+  BenchmarkArgs* args = parseArgs(argc, argv);
+
+  cout << "Benchmark parameters:" << endl;
+  cout << " - Mode = "
+       << (args->scaling        ? "scaling"
+           : args->orders       ? "sweep orders"
+           : args->acceleration ? "acceleration"
+                                : "microbenchmarks")
+       << endl;
+  cout << " - N (variables) =";
+  for (int N : args->N) cout << " " << N;
+  cout << endl;
+  cout << " - α (clauses/variables ratio) =";
+  for (double a : args->a) cout << " " << a;
+  cout << endl;
+  if (args->scaling) {
+    cout << " - f (assignment fraction) = " << args->f << endl;
+    if (!args->baseline.empty()) {
+      cout << " - Baseline = " << args->baseline << endl;
+      cout << " - Tolerance = " << args->tolerance << endl;
+    }
+  } else {
+    cout << " - Repetitions = " << args->reps << endl;
+  }
+  if (!args->orders) {
+    cout << " - SP sweep order = " << Solver::SweepOrderName(args->sweepOrder)
+         << endl;
+  }
+  cout << " - Graph order = " << FactorGraph::GraphOrderName(args->graphOrder)
+       << endl;
+  cout << " - Threads = " << args->threads << endl;
+  cout << " - Survey precision = " << SurveyPrecision<Survey>::Name() << " ("
+       << sizeof(Edge) << " bytes per edge)" << endl;
+  cout << " - Sub products = " << SubProducts::Name() << endl;
+  cout << " - Seed = " << args->s << endl;
+  cout << endl;
+
+  int ret;
+  if (args->scaling)
+    ret = scaling(args);
+  else if (args->orders)
+    ret = sweepOrders(args);
+  else if (args->acceleration)
+    ret = acceleration(args);
+  else
+    ret = microbenchmarks(args);
+  delete args;
+  return ret;
+}
@@ -1,8 +1,10 @@
 #include <string.h>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -10,7 +12,11 @@
 // Project includes
 #include <Configuration.hpp>
 #include <FactorGraph.hpp>
+#include <Memory.hpp>
+#include <Portfolio.hpp>
+#include <Preprocessor.hpp>
 #include <Solver.hpp>
+#include <Tuner.hpp>
 #include <Validator.hpp>
 
 using namespace sat;
@@ -27,9 +33,51 @@ struct ExperimentArgs {
   int m;
   string baseDir;
   int I = 50;
-  double fractionParams[6] = {0.04, 0.02, 0.01, 0.005, 0.0025, 0.00125};
+  vector<double> fractionParams = {0.04, 0.02, 0.01, 0.005, 0.0025, 0.00125};
   int c = 100;
   double Q = -1;
+
+  // Options
+  string metrics = "";  // Store per instance solver metrics (csv|json)
+  bool trace = false;   // Store per instance Chrome trace of SID
+  bool estimateMemory = false;  // Only estimate the memory of an instance
+  SweepOrder sweepOrder = SWEEP_SHUFFLE;  // Clause order of the SP sweeps
+  GraphOrder graphOrder = ORDER_DIMACS;   // Storage order of the graphs
+  bool preprocess = false;  // Simplify the instances before SID
+  bool eliminate = false;   // Bounded variable elimination while simplifying
+  bool components = false;  // Solve the independent components apart
+  int threads = 1;          // Threads of the solver
+  bool spParamagnetic = false;  // Check the paramagnetic state in every SP it.
+  DecimationSchedule schedule = SCHEDULE_FIXED;  // Variables fixed per round
+  double minFraction = 0.00125;  // Lower bound of the adaptive schedule
+  double spDamping = 0.0;        // Weight of the previous survey in SP
+  int spStallWindow = 0;         // Iterations without progress to stall SP
+  int spAndersonDepth = 0;       // Anderson acceleration of SP
+  int spMaxIt = 1000;            // Iterations of SP before UNCONVERGE
+  double spEpsilon = 0.001;      // Max survey difference to converge
+  double paramagneticState = 0.01;  // Average max bias to call walksat
+  int wsMaxTries = 10;              // Walksat restarts
+  int wsMaxFlips = 0;               // Walksat flips of every try (0: 100 N)
+  double wsNoise = 0.57;            // Probability of a random walk flip
+  string config = "";               // File with the tuned options to load
+  int tune = 0;                     // Random configs of the tuner (0: off)
+  int portfolio = 0;                // SID runs of every instance (0: off)
+  double budget = 0;                // Seconds of every portfolio (0: none)
+  double timeout = 0;               // Seconds of every SID run (0: none)
+};
+
+// -----------------------------------------------------------------------------
+// Results of the instances solved with one fraction
+// -----------------------------------------------------------------------------
+struct FractionResults {
+  int sat = 0;
+  int spSATIterations = 0;  // SP iterations of the SAT instances
+  int unconverged = 0;
+  int sidIterationsInUnconverged = 0;
+  int contradictions = 0;
+  int indeterminate = 0;
+  int timeouts = 0;
+  chrono::steady_clock::duration time = chrono::steady_clock::duration::zero();
 };
 
 // -----------------------------------------------------------------------------
@@ -44,6 +92,9 @@ void buildDirs(ExperimentArgs* args) {
   std::filesystem::create_directories(baseDir);
   std::filesystem::create_directory(baseDir + "/cnf");
   std::filesystem::create_directory(baseDir + "/cnf-solutions");
+  if (!args->metrics.empty())
+    std::filesystem::create_directory(baseDir + "/metrics");
+  if (args->trace) std::filesystem::create_directory(baseDir + "/traces");
 
   args->baseDir = baseDir;
 }
@@ -80,28 +131,189 @@ void createCNFFiles(ExperimentArgs* args) {
 // -----------------------------------------------------------------------------
 // Parse command line arguments
 // -----------------------------------------------------------------------------
+void printUsage() {
+  cout << "Usage:" << endl;
+  cout << "\t./experiment N a random seed [options]" << endl;
+  cout << "\t./experiment N a community Q seed [options]" << endl;
+  cout << "If seed = 0, random seed is used" << endl;
+  cout << "Options:" << endl;
+  cout << "\t--metrics=[csv|json]  Store solver metrics of every instance"
+       << endl;
+  cout << "\t--trace               Store a Chrome trace of every instance"
+       << endl;
+  cout << "\t--sweep=[shuffle|block|permutations|offset]" << endl;
+  cout << "\t                      Clause order of the SP sweeps" << endl;
+  cout << "\t--graph-order=[dimacs|rcm]" << endl;
+  cout << "\t                      Storage order of the variables and clauses"
+       << endl;
+  cout << "\t--preprocess[=bve]    Simplify the instances before SID (bve: also"
+       << endl;
+  cout << "\t                      eliminate variables)" << endl;
+  cout << "\t--components          Solve the independent components apart"
+       << endl;
+  cout << "\t--threads=T           Threads used by the solver" << endl;
+  cout << "\t--sp-paramagnetic     Check the paramagnetic state after every"
+       << endl;
+  cout << "\t                      SP iteration" << endl;
+  cout << "\t--schedule=[fixed|adaptive]" << endl;
+  cout << "\t                      Variables fixed in every decimation round"
+       << endl;
+  cout << "\t                      (adaptive: f is the upper bound)" << endl;
+  cout << "\t--min-fraction=f      Lower bound of the adaptive schedule"
+       << endl;
+  cout << "\t--sp-damping=d        Weight of the previous survey in SP updates"
+       << endl;
+  cout << "\t--sp-stall-window=w   Raise the damping or abort SP after w"
+       << endl;
+  cout << "\t                      iterations without progress" << endl;
+  cout << "\t--sp-anderson=m       Anderson acceleration of SP with the last m"
+       << endl;
+  cout << "\t                      sweeps" << endl;
+  cout << "\t--instances=I         CNF instances of every experiment (50)"
+       << endl;
+  cout << "\t--sp-max-it=n         SP iterations before UNCONVERGE (1000)"
+       << endl;
+  cout << "\t--sp-epsilon=e        Max survey difference of SP to converge"
+       << endl;
+  cout << "\t                      (0.001)" << endl;
+  cout << "\t--paramagnetic=p      Average max bias of the paramagnetic state"
+       << endl;
+  cout << "\t                      (0.01)" << endl;
+  cout << "\t--ws-max-tries=n      Walksat tries (10)" << endl;
+  cout << "\t--ws-max-flips=n      Walksat flips of every try (100 N)"
+       << endl;
+  cout << "\t--ws-noise=p          Probability of a random walksat flip (0.57)"
+       << endl;
+  cout << "\t--config=file         Load the tuned options (fraction, SP and"
+       << endl;
+  cout << "\t                      walksat) from a file stored by --tune"
+       << endl;
+  cout << "\t--tune[=K]            Tune the options on the instances with K"
+       << endl;
+  cout << "\t                      random configs (16) and store the best in"
+       << endl;
+  cout << "\t                      best.cfg. Uses --threads workers" << endl;
+  cout << "\t--portfolio=K         Solve every instance with K SID runs at the"
+       << endl;
+  cout << "\t                      same time (fractions, schedules and seeds)"
+       << endl;
+  cout << "\t                      on --threads workers" << endl;
+  cout << "\t--budget=s            Seconds of every portfolio (no limit)"
+       << endl;
+  cout << "\t--timeout=s           Seconds of every SID run (no limit)" << endl;
+  cout << "\t./experiment N a --estimate-memory" << endl;
+  cout << "\t\tEstimate the memory needed to solve a 3-SAT instance" << endl;
+}
+
 ExperimentArgs* parseArgs(int argc, char* argv[]) {
   ExperimentArgs* args = new ExperimentArgs();
 
+  // Separate positional arguments from options (--name=value)
+  vector<char*> positional;
+  for (int i = 0; i < argc; i++) {
+    if (strncmp(argv[i], "--", 2) != 0) {
+      positional.push_back(argv[i]);
+      continue;
+    }
+
+    string option = argv[i] + 2;
+    string name = option.substr(0, option.find('='));
+    string value = option.find('=') == string::npos
+                       ? ""
+                       : option.substr(option.find('=') + 1);
+    if (name == "metrics" && (value == "csv" || value == "json")) {
+      args->metrics = value;
+    } else if (name == "trace" && value.empty()) {
+      args->trace = true;
+    } else if (name == "estimate-memory" && value.empty()) {
+      args->estimateMemory = true;
+    } else if (name == "preprocess" && (value.empty() || value == "bve")) {
+      args->preprocess = true;
+      args->eliminate = value == "bve";
+    } else if (name == "components" && value.empty()) {
+      args->components = true;
+    } else if (name == "sp-paramagnetic" && value.empty()) {
+      args->spParamagnetic = true;
+    } else if (name == "schedule" &&
+               Solver::ParseSchedule(value, args->schedule)) {
+      // Schedule stored by ParseSchedule
+    } else if (name == "min-fraction" && atof(value.c_str()) > 0) {
+      args->minFraction = atof(value.c_str());
+    } else if (name == "sp-damping" && atof(value.c_str()) >= 0 &&
+               atof(value.c_str()) < 1) {
+      args->spDamping = atof(value.c_str());
+    } else if (name == "sp-stall-window" && atoi(value.c_str()) > 0) {
+      args->spStallWindow = atoi(value.c_str());
+    } else if (name == "sp-anderson" && atoi(value.c_str()) > 0) {
+      args->spAndersonDepth = atoi(value.c_str());
+    } else if (name == "instances" && atoi(value.c_str()) > 0) {
+      args->I = atoi(value.c_str());
+    } else if (name == "sp-max-it" && atoi(value.c_str()) > 0) {
+      args->spMaxIt = atoi(value.c_str());
+    } else if (name == "sp-epsilon" && atof(value.c_str()) > 0) {
+      args->spEpsilon = atof(value.c_str());
+    } else if (name == "paramagnetic" && atof(value.c_str()) >= 0) {
+      args->paramagneticState = atof(value.c_str());
+    } else if (name == "ws-max-tries" && atoi(value.c_str()) > 0) {
+      args->wsMaxTries = atoi(value.c_str());
+    } else if (name == "ws-max-flips" && atoi(value.c_str()) > 0) {
+      args->wsMaxFlips = atoi(value.c_str());
+    } else if (name == "ws-noise" && atof(value.c_str()) >= 0 &&
+               atof(value.c_str()) <= 1) {
+      args->wsNoise = atof(value.c_str());
+    } else if (name == "config" && !value.empty()) {
+      args->config = value;
+    } else if (name == "tune" && value.empty()) {
+      args->tune = 16;
+    } else if (name == "tune" && atoi(value.c_str()) > 0) {
+      args->tune = atoi(value.c_str());
+    } else if (name == "portfolio" && atoi(value.c_str()) > 0) {
+      args->portfolio = atoi(value.c_str());
+    } else if (name == "budget" && atof(value.c_str()) > 0) {
+      args->budget = atof(value.c_str());
+    } else if (name == "timeout" && atof(value.c_str()) > 0) {
+      args->timeout = atof(value.c_str());
+    } else if (name == "threads" && atoi(value.c_str()) > 0) {
+      args->threads = atoi(value.c_str());
+    } else if (name == "sweep" &&
+               Solver::ParseSweepOrder(value, args->sweepOrder)) {
+      // Order stored by ParseSweepOrder
+    } else if (name == "graph-order" &&
+               FactorGraph::ParseGraphOrder(value, args->graphOrder)) {
+      // Order stored by ParseGraphOrder
+    } else {
+      cout << "Invalid option " << argv[i] << endl;
+      printUsage();
+      exit(-1);
+    }
+  }
+
+  // Memory estimation only needs N and a
+  int totalPositional = positional.size();
+  if (args->estimateMemory && totalPositional == 3) {
+    args->N = atoi(positional[1]);
+    args->a = atof(positional[2]);
+    args->m = args->N * args->a;
+    return args;
+  }
+
   // Check number of arguments
-  if (argc != 5 && argc != 6) {
-    cout << "Usage:" << endl;
-    cout << "\t./experiment N a random seed" << endl;
-    cout << "\t./experiment N a community seed Q" << endl;
-    cout << "If seed = 0, random seed is used" << endl;
+  if (totalPositional != 5 && totalPositional != 6) {
+    printUsage();
     exit(-1);
   }
 
   // Read arguments
-  args->N = atoi(argv[1]);
-  args->a = atof(argv[2]);
-  if (strcmp(argv[3], "random") == 0 || strcmp(argv[3], "community") == 0) {
-    args->g = argv[3];
-    if (strcmp(argv[3], "community") == 0) {
-      args->Q = atof(argv[4]);
-      args->s = atoi(argv[5]);
+  args->N = atoi(positional[1]);
+  args->a = atof(positional[2]);
+  if (strcmp(positional[3], "random") == 0 ||
+      strcmp(positional[3], "community") == 0) {
+    args->g = positional[3];
+    if (strcmp(positional[3], "community") == 0) {
+      args->Q = atof(positional[4]);
+      args->s = atoi(positional[5]);
     } else
-      args->s = atoi(argv[4]);
+      args->s = atoi(positional[4]);
   } else {
     cout << "Invalid cnf generator. Use random or community";
     exit(-1);
@@ -113,6 +325,93 @@ ExperimentArgs* parseArgs(int argc, char* argv[]) {
   return args;
 }
 
+// -----------------------------------------------------------------------------
+// Set the solver options of the command line
+// -----------------------------------------------------------------------------
+void configureSolver(Solver& solver, const ExperimentArgs* args) {
+  solver.sweepOrder = args->sweepOrder;
+  solver.components = args->components;
+  solver.threads = args->threads;
+  solver.spParamagneticCheck = args->spParamagnetic;
+  solver.schedule = args->schedule;
+  solver.minFraction = args->minFraction;
+  solver.spDamping = args->spDamping;
+  solver.spStallWindow = args->spStallWindow;
+  solver.spAndersonDepth = args->spAndersonDepth;
+  solver.spMaxIt = args->spMaxIt;
+  solver.spEpsilon = args->spEpsilon;
+  solver.paramagneticState = args->paramagneticState;
+  solver.wsMaxTries = args->wsMaxTries;
+  if (args->wsMaxFlips > 0) solver.wsMaxFlips = args->wsMaxFlips;
+  solver.wsNoise = args->wsNoise;
+  if (args->fractionParams.size() == 1)
+    solver.sidFraction = args->fractionParams[0];
+}
+
+// -----------------------------------------------------------------------------
+// Tune the options on the instances and store the best ones
+// -----------------------------------------------------------------------------
+void tuneOptions(ExperimentArgs* args, Solver& solver) {
+  cout << endl;
+  cout << "Tuning " << args->tune << " random configs and the options of the "
+       << "command line on " << args->I << " instances (" << args->threads
+       << " workers)..." << endl;
+
+  vector<string> instances;
+  for (int i = 1; i <= args->I; i++)
+    instances.push_back(args->baseDir + "/cnf/" + to_string(i) + ".cnf");
+  Tuner tuner(instances, args->N, args->a, solver.initialSeed);
+  tuner.configs = args->tune;
+  tuner.threads = args->threads;
+  tuner.graphOrder = args->graphOrder;
+  tuner.preprocess = args->preprocess;
+  tuner.variableElimination = args->eliminate;
+  tuner.timeout = args->timeout;
+
+  // The solvers of the workers log to cout, silenced while tuning
+  streambuf* buffer = cout.rdbuf(nullptr);
+  TunerCandidate best =
+      tuner.Run([&solver](Solver& worker) { worker.copyOptions(solver); });
+  cout.rdbuf(buffer);
+
+  // All the candidates, best first
+  ofstream tuneFile(args->baseDir + "/tune.csv");
+  tuneFile << "f,spepsilon,paramagnetic,wsnoise,wsmaxflips,rounds,instances,"
+              "sat,timeout,totaltime\n";
+  cout << endl;
+  cout << "Candidates (best first):" << endl;
+  for (const TunerCandidate& candidate : tuner.candidates) {
+    ostringstream row;
+    row << candidate.fraction << "," << candidate.spEpsilon << ","
+        << candidate.paramagneticState << "," << candidate.wsNoise << ","
+        << candidate.wsMaxFlips << "," << candidate.rounds << ","
+        << candidate.instances << "," << candidate.solved << ","
+        << candidate.timeouts << "," << candidate.seconds;
+    tuneFile << row.str() << "\n";
+    cout << " " << row.str() << endl;
+  }
+  if (tuner.candidates.size() == 1) {
+    cerr << "ERROR: Can't read the instances to tune" << endl;
+    exit(-1);
+  }
+
+  best.Apply(solver);
+  string configFile = args->baseDir + "/best.cfg";
+  if (!solver.storeOptions(configFile)) {
+    cerr << "ERROR: Can't store the options in " << configFile << endl;
+    exit(-1);
+  }
+  cout << endl;
+  cout << "Best options: f = " << best.fraction
+       << ", SP epsilon = " << best.spEpsilon
+       << ", paramagnetic state = " << best.paramagneticState
+       << ", WalkSAT noise = " << best.wsNoise
+       << ", flips = " << best.wsMaxFlips << " (" << best.solved << "/"
+       << best.instances << " SAT in " << best.seconds << "s)" << endl;
+  cout << "Stored in " << configFile << " (use --config=" << configFile
+       << ")" << endl;
+}
+
 // Entry point
 int main(int argc, char* argv[]) {
   // ---------------------------------------------------------------------------
@@ -120,6 +419,34 @@ int main(int argc, char* argv[]) {
   // ---------------------------------------------------------------------------
   ExperimentArgs* args = parseArgs(argc, argv);
 
+  if (args->estimateMemory) {
+    MemoryUsage usage = FactorGraph::EstimateMemoryUsage(args->N, args->m);
+    usage += Solver::EstimateMemoryUsage(args->N, args->m);
+    cout << "Estimated memory for N = " << args->N << ", α = " << args->a
+         << " (3-SAT):" << endl;
+    cout << usage;
+    return 0;
+  }
+
+  Validator validator;
+  Solver solver(args->N, args->a, args->s);
+  configureSolver(solver, args);
+
+  // The options of the file replace the ones of the command line
+  if (!args->config.empty()) {
+    if (!solver.loadOptions(args->config)) {
+      cerr << "ERROR: Can't load the options of " << args->config << endl;
+      exit(-1);
+    }
+    args->fractionParams = {solver.sidFraction};
+    args->spMaxIt = solver.spMaxIt;
+    args->spEpsilon = solver.spEpsilon;
+    args->paramagneticState = solver.paramagneticState;
+    args->wsMaxTries = solver.wsMaxTries;
+    args->wsMaxFlips = solver.wsMaxFlips;
+    args->wsNoise = solver.wsNoise;
+  }
+
   cout << "===========================================================" << endl;
   cout << "==                  RUNNING  EXPERIMENT                  ==" << endl;
   cout << "===========================================================" << endl;
@@ -129,6 +456,45 @@ int main(int argc, char* argv[]) {
   cout << " - α (clauses/variables ratio) = " << args->a << endl;
   cout << " - 3-SAT CNF generator = " << args->g << endl;
   cout << " - Seed = " << args->s << endl;
+  cout << " - SP sweep order = " << Solver::SweepOrderName(args->sweepOrder)
+       << endl;
+  cout << " - Graph order = " << FactorGraph::GraphOrderName(args->graphOrder)
+       << endl;
+  cout << " - Preprocessing = "
+       << (args->eliminate ? "bve" : args->preprocess ? "yes" : "no") << endl;
+  cout << " - Components = " << (args->components ? "yes" : "no") << endl;
+  cout << " - Threads = " << args->threads << endl;
+  cout << " - Paramagnetic check in SP = "
+       << (args->spParamagnetic ? "yes" : "no") << endl;
+  cout << " - Decimation schedule = " << Solver::ScheduleName(args->schedule);
+  if (args->schedule == SCHEDULE_ADAPTIVE)
+    cout << " (min fraction " << args->minFraction << ")";
+  cout << endl;
+  cout << " - SP damping = " << args->spDamping << endl;
+  cout << " - SP stall window = " << args->spStallWindow << endl;
+  cout << " - SP Anderson depth = " << args->spAndersonDepth << endl;
+  cout << " - Instances = " << args->I << endl;
+  cout << " - SP max iterations = " << args->spMaxIt << endl;
+  cout << " - SP epsilon = " << args->spEpsilon << endl;
+  cout << " - Paramagnetic state = " << args->paramagneticState << endl;
+  cout << " - WalkSAT tries = " << args->wsMaxTries << ", flips = "
+       << (args->wsMaxFlips > 0 ? args->wsMaxFlips : 100 * args->N)
+       << ", noise = " << args->wsNoise << endl;
+  cout << " - Survey precision = " << SurveyPrecision<Survey>::Name() << endl;
+  cout << " - Sub products = " << SubProducts::Name() << endl;
+  if (!args->config.empty())
+    cout << " - Options file = " << args->config << " (f = "
+         << args->fractionParams[0] << ")" << endl;
+  if (args->tune > 0) cout << " - Tuned configs = " << args->tune << endl;
+  if (args->portfolio > 0) {
+    cout << " - Portfolio = " << args->portfolio << " runs";
+    if (args->budget > 0) cout << " (budget " << args->budget << "s)";
+    cout << endl;
+  }
+  if (args->timeout > 0)
+    cout << " - Timeout = " << args->timeout << "s" << endl;
+  cout << " - Instrumentation = "
+       << (Configuration::instrumentation ? "yes" : "no") << endl;
   if (args->Q >= 0) {
     cout << " - c (communities) = 100" << endl;
     cout << " - Q = " << args->Q << endl;
@@ -139,17 +505,27 @@ int main(int argc, char* argv[]) {
 
   buildDirs(args);
   ofstream resultFile;
-  resultFile.open(args->baseDir + "/result.csv");
-  if (args->Q < 0)
-    resultFile
-        << "N,a,f,sat,sp,unconv,avgsiditinunconv,contr,indet,totaltime\n";
-  else
-    resultFile
-        << "N,a,Q,f,sat,sp,unconv,avgsiditinunconv,contr,indet,totaltime\n";
-  resultFile.close();
+  if (args->tune == 0) {
+    resultFile.open(args->baseDir + "/result.csv");
+    if (args->Q < 0)
+      resultFile
+          << "N,a,f,sat,sp,unconv,avgsiditinunconv,contr,indet,timeout,"
+             "totaltime\n";
+    else
+      resultFile
+          << "N,a,Q,f,sat,sp,unconv,avgsiditinunconv,contr,indet,timeout,"
+             "totaltime\n";
+    resultFile.close();
+  }
 
-  Validator validator;
-  Solver solver(args->N, args->a, args->s);
+  solver.metrics.enabled = !args->metrics.empty();
+  bool instrumented = solver.metrics.enabled || args->trace;
+  if (!Configuration::instrumentation && instrumented)
+    cout << "WARNING: built without instrumentation, metrics and traces are "
+            "empty"
+         << endl;
+  Trace trace;
+  if (args->trace) solver.trace = &trace;
   if (args->s == 0) cout << "Random seed: " << solver.initialSeed << endl;
 
   cout << "Generating CNF files..." << endl;
@@ -157,81 +533,231 @@ int main(int argc, char* argv[]) {
 
   cout << "Done!" << endl;
 
+  if (args->tune > 0) {
+    tuneOptions(args, solver);
+    return 0;
+  }
+
   // ---------------------------------------------------------------------------
   // Run experiments
   // ---------------------------------------------------------------------------
-  int experimentId = 1;
-  resultFile.open(args->baseDir + "/result.csv", ofstream::app);
-  for (double fraction : args->fractionParams) {
-    cout << endl << endl;
-    cout << "------------------------------" << endl;
-    cout << "Experiment " << experimentId << ":" << endl;
-    cout << " - N: " << args->N << endl;
-    cout << " - α: " << args->a << endl;
-    if (args->Q >= 0) cout << " - Q: " << args->Q << endl;
-    cout << " - f: " << fraction << endl;
-    cout << "------------------------------" << endl;
-
-    // Metrics
-    int totalSATInstances = 0;
-    int totalSPSATIterations = 0;
-    int totalUnconvergedInstances = 0;
-    int totalContradictionsInstances = 0;
-    int totalIndeterminateInstances = 0;
-    int totalSIDIterationsInUnconverged = 0;
-    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
-
+  // Portfolio of every instance: member m uses the fraction m of the list
+  // and alternates the schedules and the sweep orders
+  Portfolio portfolio;
+  portfolio.threads = args->threads;
+  portfolio.budget = args->budget;
+  for (int m = 0; m < args->portfolio; m++) {
+    portfolio.Add(
+        args->fractionParams[m % args->fractionParams.size()],
+        m % 2 ? SCHEDULE_ADAPTIVE : args->schedule,
+        (SweepOrder)((args->sweepOrder + m / 2) % TOTAL_SWEEP_ORDERS));
+  }
+  auto configure = [&solver](Solver& member) { member.copyOptions(solver); };
+
+  // With a portfolio every instance is solved once, and f is 0
+  vector<double> fractions = args->fractionParams;
+  if (args->portfolio > 0) fractions = {0.0};
+
+  // Every instance is parsed (and preprocessed) once per pass and solved with
+  // all the fractions it needs before the next one, so only one graph is in
+  // memory at a time. The fractions needed are the ones up to the first one
+  // that solves all the instances (or all of them): every instance is solved
+  // until its first SAT fraction and at least until the last fraction needed
+  // so far, and the instances behind it are solved again in the next pass
+  vector<FractionResults> results(fractions.size());
+  vector<vector<AlgorithmResult>> instanceResults(args->I);
+  unsigned lastFraction = 0;
+  auto needsRun = [&](const vector<AlgorithmResult>& runs) {
+    if (runs.size() == fractions.size()) return false;
+    return runs.size() <= lastFraction ||
+           find(runs.begin(), runs.end(), SAT) == runs.end();
+  };
+
+  while (true) {
     for (int i = 1; i <= args->I; i++) {
+      vector<AlgorithmResult>& runs = instanceResults[i - 1];
+      if (!needsRun(runs)) continue;
+
+      // The time of the parse is added to the first run
+      chrono::steady_clock::time_point beginRun = chrono::steady_clock::now();
       string path = args->baseDir + "/cnf/" + to_string(i) + ".cnf";
       ifstream file(path);
       if (!file.is_open()) {
         cerr << "ERROR: Can't open file " << path << endl;
         exit(-1);
       }
-      cout << "Solving file " << path << endl;
-
-      FactorGraph* graph = new FactorGraph(file);
-      chrono::steady_clock::time_point beginSID = chrono::steady_clock::now();
-      AlgorithmResult result = solver.SID(graph, fraction);
-      chrono::steady_clock::time_point endSID = chrono::steady_clock::now();
-
-      // Get result and update metrics
-      if (result == SAT) {
-        totalSATInstances++;
-        totalSPSATIterations += solver.totalSPIterations;
-        string solFile =
-            args->baseDir + "/cnf-solutions/" + to_string(i) + ".cnf.sol";
-        graph->storeVariableValues(solFile);
-        bool valid = validator.validateResult(path, solFile);
-        cout << "Solved: SAT" << endl;
-        if (!valid) {
-          cerr << "ERROR: Solution not valid!" << endl;
-          exit(-1);
-        }
-      } else if (result == UNCONVERGE) {
-        totalUnconvergedInstances++;
-        totalSIDIterationsInUnconverged += solver.totalSIDIterations;
-        cout << "Solved: UNCONVERGE" << endl;
-      } else if (result == CONTRADICTION) {
-        totalContradictionsInstances++;
-        cout << "Solved: CONTRADICTION" << endl;
-      } else if (result == INDETERMINATE) {
-        totalIndeterminateInstances++;
-        cout << "Solved: INDETERMINATE" << endl;
+      MemoryUsage estimation = FactorGraph::EstimateMemoryUsage(file);
+      cout << "Estimated graph memory: " << estimation.Total() / 1048576.0
+           << "MB" << endl;
+      file.clear();
+      file.seekg(0);
+      // With preprocessing, the graph is the simplified instance. Instances
+      // found UNSAT while simplifying are not solved
+      unique_ptr<Preprocessor> preprocessor;
+      unique_ptr<FactorGraph> graph;
+      bool refuted = false;
+      if (args->preprocess) {
+        // The original graph is only needed to read the clauses
+        FactorGraph original(file);
+        preprocessor.reset(new Preprocessor(original));
+        preprocessor->variableElimination = args->eliminate;
+        refuted = !preprocessor->Run();
+        cout << "Preprocessing: " << *preprocessor;
+        graph.reset(preprocessor->BuildGraph(args->graphOrder));
+      } else {
+        graph.reset(new FactorGraph(file, args->graphOrder));
       }
 
-      // Print elapsed time
-      cout << "Elapsed time: "
-           << chrono::duration_cast<chrono::seconds>(endSID - beginSID).count()
-           << "s" << endl;
-      cout << endl;
+      // The graph is reset before every run but the first one
+      for (bool first = true; needsRun(runs); first = false) {
+        unsigned k = runs.size();
+        double fraction = fractions[k];
+        FractionResults& fractionResults = results[k];
+        if (!first) graph->Reset();
+        cout << "Solving file " << path;
+        if (args->portfolio == 0) cout << " with f = " << fraction;
+        cout << endl;
+        if (refuted) {
+          runs.push_back(CONTRADICTION);
+          fractionResults.contradictions++;
+          cout << "Solved: CONTRADICTION (preprocessing)" << endl << endl;
+          lastFraction = max(lastFraction, k);
+          continue;
+        }
+
+        // Every instance uses its own random stream, so its result does not
+        // depend on the instances solved before
+        solver.setSeed(solver.initialSeed, i);
+        trace.Clear();
+        ResetPeakRSS();
+        chrono::steady_clock::time_point beginSID =
+            chrono::steady_clock::now();
+        AlgorithmResult result;
+        int spIterations, sidIterations;
+        if (args->portfolio > 0) {
+          result =
+              portfolio.Solve(graph.get(), solver.initialSeed, i, configure);
+          const PortfolioMember& winner = portfolio.members[portfolio.winner];
+          spIterations = winner.spIterations;
+          sidIterations = winner.sidIterations;
+          if (result == SAT) {
+            cout << "Portfolio: run " << portfolio.winner + 1 << " (f "
+                 << winner.fraction << ", "
+                 << Solver::ScheduleName(winner.schedule) << " schedule, "
+                 << Solver::SweepOrderName(winner.sweepOrder) << " sweep)"
+                 << endl;
+          } else if (portfolio.expired) {
+            cout << "Portfolio: budget over" << endl;
+          } else {
+            cout << "Portfolio: no run found a solution" << endl;
+          }
+        } else {
+          solver.setTimeLimit(args->timeout);
+          result = solver.SID(graph.get(), fraction);
+          spIterations = solver.totalSPIterations;
+          sidIterations = solver.totalSIDIterations;
+        }
+        chrono::steady_clock::time_point endSID = chrono::steady_clock::now();
+        runs.push_back(result);
+
+        // Get result and update metrics
+        if (result == SAT) {
+          fractionResults.sat++;
+          fractionResults.spSATIterations += spIterations;
+          string solFile =
+              args->baseDir + "/cnf-solutions/" + to_string(i) + ".cnf.sol";
+          if (preprocessor)
+            preprocessor->storeModel(*graph, solFile);
+          else
+            graph->storeVariableValues(solFile);
+          bool valid = validator.validateResult(path, solFile);
+          cout << "Solved: SAT" << endl;
+          if (!valid) {
+            cerr << "ERROR: Solution not valid!" << endl;
+            exit(-1);
+          }
+        } else if (result == UNCONVERGE) {
+          fractionResults.unconverged++;
+          fractionResults.sidIterationsInUnconverged += sidIterations;
+          cout << "Solved: UNCONVERGE" << endl;
+        } else if (result == CONTRADICTION) {
+          fractionResults.contradictions++;
+          cout << "Solved: CONTRADICTION" << endl;
+        } else if (result == INDETERMINATE) {
+          fractionResults.indeterminate++;
+          cout << "Solved: INDETERMINATE" << endl;
+        } else if (result == TIMEOUT) {
+          fractionResults.timeouts++;
+          cout << "Solved: TIMEOUT" << endl;
+        }
+        if (args->spAndersonDepth > 0 && args->portfolio == 0) {
+          cout << "SP iterations: " << solver.totalSPIterations << " ("
+               << solver.totalSPExtrapolations << " Anderson steps, "
+               << solver.totalSPFallbacks << " reverted)" << endl;
+        }
 
-      delete graph;
+        // Store solver metrics of the instance
+        if (solver.metrics.enabled && args->portfolio == 0) {
+          ostringstream metricsFile;
+          metricsFile << args->baseDir << "/metrics/" << fraction << "-" << i
+                      << "." << args->metrics;
+          if (args->metrics == "csv")
+            solver.metrics.storeCSV(metricsFile.str());
+          else
+            solver.metrics.storeJSON(metricsFile.str());
+          cout << "Metrics:" << endl << solver.metrics;
+        }
+
+        // Store the trace of the instance
+        if (solver.trace && args->portfolio == 0) {
+          ostringstream traceFile;
+          traceFile << args->baseDir << "/traces/" << fraction << "-" << i
+                    << ".json";
+          trace.storeJSON(traceFile.str());
+        }
+
+        // Print memory usage
+        MemoryUsage usage = graph->GetMemoryUsage();
+        usage += solver.GetMemoryUsage();
+        cout << "Graph + solver memory: " << usage.Total() / 1048576.0 << "MB"
+             << endl;
+        cout << "Peak RSS: " << GetPeakRSS() / 1024.0 << "MB" << endl;
+
+        // Print elapsed time
+        cout << "Elapsed time: "
+             << chrono::duration_cast<chrono::seconds>(endSID - beginSID)
+                    .count()
+             << "s" << endl;
+        cout << endl;
+
+        chrono::steady_clock::time_point endRun = chrono::steady_clock::now();
+        fractionResults.time += endRun - beginRun;
+        beginRun = endRun;
+        lastFraction = max(lastFraction, k);
+      }
     }
-    chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+    // Once all the instances are solved up to the last fraction needed, the
+    // next one is only needed if it doesn't solve all of them
+    bool behind = false;
+    for (const vector<AlgorithmResult>& runs : instanceResults)
+      behind = behind || needsRun(runs);
+    if (behind) continue;
+    if (results[lastFraction].sat == args->I ||
+        lastFraction + 1 == fractions.size())
+      break;
+    lastFraction++;
+  }
+
+  resultFile.open(args->baseDir + "/result.csv", ofstream::app);
+  for (unsigned k = 0; k <= lastFraction; k++) {
+    double fraction = fractions[k];
+    const FractionResults& fractionResults = results[k];
+    chrono::seconds totalTime =
+        chrono::duration_cast<chrono::seconds>(fractionResults.time);
 
     // Results
-    double satInstPercent = totalSATInstances * 100.0 / args->I;
+    double satInstPercent = fractionResults.sat * 100.0 / args->I;
     cout << endl;
     if (args->Q < 0)
       cout << "Results [" << args->N << " - " << args->a << " - " << fraction
@@ -240,19 +766,20 @@ int main(int argc, char* argv[]) {
       cout << "Results [" << args->N << " - " << args->a << " - " << args->Q
            << " - " << fraction << "]:" << endl;
     cout << " SAT: ";
-    cout << totalSATInstances << " (" << satInstPercent << "%)" << endl;
-    cout << " SP it.: " << totalSPSATIterations << endl;
-    cout << " UNCONVERGED: " << totalUnconvergedInstances << endl;
-    if (totalUnconvergedInstances != 0) {
+    cout << fractionResults.sat << " (" << satInstPercent << "%)" << endl;
+    cout << " SP it.: " << fractionResults.spSATIterations << endl;
+    cout << " UNCONVERGED: " << fractionResults.unconverged << endl;
+    if (fractionResults.unconverged != 0) {
       cout << " Avg SID it. in UNCONVERGE: "
-           << (totalSIDIterationsInUnconverged / totalUnconvergedInstances)
+           << (fractionResults.sidIterationsInUnconverged /
+               fractionResults.unconverged)
            << endl;
     }
-    cout << " CONTRADICTION: " << totalContradictionsInstances << endl;
-    cout << " INDETERMINATE: " << totalIndeterminateInstances << endl;
+    cout << " CONTRADICTION: " << fractionResults.contradictions << endl;
+    cout << " INDETERMINATE: " << fractionResults.indeterminate << endl;
+    cout << " TIMEOUT: " << fractionResults.timeouts << endl;
     cout << " Total time: ";
-    cout << chrono::duration_cast<chrono::seconds>(end - begin).count() << "s"
-         << endl;
+    cout << totalTime.count() << "s" << endl;
     cout << endl;
 
     // Store result
@@ -261,28 +788,20 @@ int main(int argc, char* argv[]) {
     else
       resultFile << args->N << "," << args->a << "," << args->Q << ","
                  << fraction << ",";
-    resultFile << totalSATInstances << "," << totalSPSATIterations << ","
-               << totalUnconvergedInstances << ",";
-    if (totalUnconvergedInstances != 0) {
-      resultFile << (totalSIDIterationsInUnconverged /
-                     totalUnconvergedInstances)
+    resultFile << fractionResults.sat << "," << fractionResults.spSATIterations
+               << "," << fractionResults.unconverged << ",";
+    if (fractionResults.unconverged != 0) {
+      resultFile << (fractionResults.sidIterationsInUnconverged /
+                     fractionResults.unconverged)
                  << ",";
     } else {
       resultFile << "0,";
     }
-    resultFile << totalContradictionsInstances << ","
-               << totalIndeterminateInstances << ","
-               << chrono::duration_cast<chrono::seconds>(end - begin).count()
-               << "\n";
-
-    // increase experiment id
-    experimentId++;
-
-    // If all instances solved, stop experiment, if not, continue with next f
-    if (args->I == totalSATInstances) break;
+    resultFile << fractionResults.contradictions << ","
+               << fractionResults.indeterminate << ","
+               << fractionResults.timeouts << "," << totalTime.count() << "\n";
   }
-
   resultFile.close();
 
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+namespace sat {
+
+// =============================================================================
+// AndersonAcceleration
+//
+// Anderson mixing for a fixed-point iteration x = G(x) on a vector of doubles.
+// After every application of G, the next iterate is the combination of the
+// last depth results of G whose residuals G(x) - x combine to the smallest
+// norm (least squares over the differences of the residuals, Walker & Ni).
+// Values are kept in [lower, upper], so it can be used with probabilities.
+// =============================================================================
+class AndersonAcceleration {
+ public:
+  // ---------------------------------------------------------------------------
+  // AndersonAcceleration constructor
+  //
+  // size is the length of the iterates and depth the number of previous
+  // iterates used in every extrapolation
+  // ---------------------------------------------------------------------------
+  AndersonAcceleration(unsigned size, unsigned depth, double lower = 0.0,
+                       double upper = 1.0);
+
+  // ---------------------------------------------------------------------------
+  // Extrapolate
+  //
+  // Add the iterate x and its image g = G(x) to the history and store in next
+  // the extrapolated iterate. Returns false (and next is not modified) until
+  // there are at least 2 iterates in the history or if the least squares
+  // problem is singular
+  // ---------------------------------------------------------------------------
+  bool Extrapolate(const std::vector<double>& x, const std::vector<double>& g,
+                   std::vector<double>& next);
+
+  // ---------------------------------------------------------------------------
+  // Restart
+  //
+  // Forget the history, e.g. when an extrapolated iterate was not better than
+  // the plain one
+  // ---------------------------------------------------------------------------
+  void Restart();
+
+ private:
+  unsigned size;
+  unsigned depth;
+  double lower;
+  double upper;
+
+  // Last iterate, its image and its residual
+  std::vector<double> lastG;
+  std::vector<double> lastF;
+  bool hasLast = false;
+
+  // Differences of consecutive images and residuals, as a ring of depth
+  // columns. columns is the number of valid ones and first the oldest
+  std::vector<std::vector<double>> deltaG;
+  std::vector<std::vector<double>> deltaF;
+  unsigned columns = 0;
+  unsigned first = 0;
+};
+
+}  // namespace sat
@@ -1,19 +1,59 @@
 #pragma once
 
+// Project headers
+#include <SubProducts.hpp>
+#include <Survey.hpp>
+
+namespace sat {
+
 // =============================================================================
-// Global configuration for the experiment
+// Compile time configuration of the solver
+//
+// Choices that change the data layout or the hot loops are policies, so the
+// code is compiled for them. The tunable numbers (iterations, epsilon, noise,
+// fractions...) are runtime options of the Solver and the experiment CLI.
 //
 // IMPORTANT: Run make clean-all and build again after changing this config
 // =============================================================================
 
-// Survey Propagation parameters
-#define SP_MAX_ITERATIONS 1000
-#define SP_EPSILON 0.001f
+// -----------------------------------------------------------------------------
+// SolverConfiguration
+//
+// Policies of the whole build:
+//  - SurveyType: survey stored in the edges (double, float or FixedSurvey)
+//  - SubProductsType: arithmetic of the sub products of the variables
+//    (LinearSubProducts or LogSubProducts)
+//  - Instrumentation: metrics and traces are compiled in. Without it the
+//    phase timers and trace spans of the solver are empty
+// -----------------------------------------------------------------------------
+template <typename SurveyType, typename SubProductsType, bool Instrumentation>
+struct SolverConfiguration {
+  typedef SurveyType Survey;
+  typedef SubProductsType SubProducts;
+  static constexpr bool instrumentation = Instrumentation;
+};
 
-// WALKSAT parameters
-#define WS_MAX_TRIES 100
-#define WS_MAX_FLIPS 100 * 100
-#define WS_NOISE 0.5f
+// Configuration of this build
+typedef SolverConfiguration<double, LinearSubProducts, true> Configuration;
+
+typedef Configuration::Survey Survey;
+typedef Configuration::SubProducts SubProducts;
+
+// -----------------------------------------------------------------------------
+// SweepPolicy
+//
+// Policies of the SP sweep. Every combination is compiled and the solver
+// selects the one of the formula and the options in every SP iteration:
+//  - Arity: literals of every clause (3 for 3-SAT) or 0 for any number.
+//    With a fixed arity the loops over the literals have a known size
+//  - Damped: update schedule, the new surveys are mixed with the previous ones
+//  - Tracked: every update refreshes the paramagnetic state tracker
+// -----------------------------------------------------------------------------
+template <unsigned Arity, bool Damped, bool Tracked>
+struct SweepPolicy {
+  static constexpr unsigned arity = Arity;
+  static constexpr bool damped = Damped;
+  static constexpr bool tracked = Tracked;
+};
 
-// CNF instances
-#define CNF_INSTANCES 50
+}  // namespace sat
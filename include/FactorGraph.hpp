@@ -1,15 +1,69 @@
 #pragma once
 
+#include <cstddef>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <vector>
 
+// Project headers
+#include <Configuration.hpp>
+#include <Memory.hpp>
+
 namespace sat {
 
 // Declarations to avoid circular dependencies
 class Edge;
 class FactorGraph;
 
+// =============================================================================
+// EdgeList
+//
+// Neighbour edges of a variable or a clause. The list is a range of positions
+// in the edge pool of the graph, so the positions are the same in all the
+// clones of the graph and are shared by them. Iterated as a list of Edge*
+// =============================================================================
+class EdgeList {
+ public:
+  class Iterator {
+   public:
+    Iterator(const unsigned* position, Edge* pool)
+        : position(position), pool(pool) {}
+    inline Edge* operator*() const;
+    Iterator& operator++() {
+      position++;
+      return *this;
+    }
+    bool operator!=(const Iterator& other) const {
+      return position != other.position;
+    }
+
+   private:
+    const unsigned* position;
+    Edge* pool;
+  };
+
+ public:
+  EdgeList() : first(nullptr), last(nullptr), pool(nullptr) {}
+  EdgeList(const unsigned* first, const unsigned* last, Edge* pool)
+      : first(first), last(last), pool(pool) {}
+
+  Iterator begin() const { return Iterator(first, pool); }
+  Iterator end() const { return Iterator(last, pool); }
+  size_t size() const { return last - first; }
+  bool empty() const { return first == last; }
+  inline Edge* operator[](size_t i) const;
+
+ private:
+  // The clones of a graph only change the pool
+  friend class FactorGraph;
+
+  const unsigned* first;
+  const unsigned* last;
+  Edge* pool;
+};
+
 // =============================================================================
 // Variable
 //
@@ -24,16 +78,16 @@ class Variable {
   bool assigned;
   bool value;
 
-  std::vector<Edge*> allNeighbourEdges;
-  std::vector<Edge*> positiveNeighbourEdges;
-  std::vector<Edge*> negativeNeighbourEdges;
+  EdgeList allNeighbourEdges;
 
   // Variables to store sub products to optimize the calculation of
-  // equations 26 and 31
+  // equations 26 and 31. With LogSubProducts p and m are the sums of
+  // log(1 - na->i) and pzero and mzero are always 0 (see SubProducts.hpp)
   double p;   // Pa€V+(i) (1 - na->i)
   double m;   // Pa€V-(i) (1 - na->i)
   int pzero;  // Number of surveys == 1 in p
   int mzero;  // Number of surveys == 1 in m
+  double maxBias;  // max(Hp, Hm) with the current sub products
 
   double Hp;
   double Hz;
@@ -65,6 +119,13 @@ class Variable {
   // ---------------------------------------------------------------------------
   void AssignValue(const bool newValue);
 
+  // ---------------------------------------------------------------------------
+  // Reset
+  //
+  // Unassign the variable and restore the initial sub products
+  // ---------------------------------------------------------------------------
+  void Reset();
+
   // ---------------------------------------------------------------------------
   // operator<<
   //
@@ -86,7 +147,7 @@ class Clause {
   bool enabled;
   int trueLiterals = 0;
 
-  std::vector<Edge*> allNeighbourEdges;
+  EdgeList allNeighbourEdges;
 
  public:
   // ---------------------------------------------------------------------------
@@ -112,6 +173,13 @@ class Clause {
   // ---------------------------------------------------------------------------
   void Dissable();
 
+  // ---------------------------------------------------------------------------
+  // Reset
+  //
+  // Enable the clause and clear the true literals counter
+  // ---------------------------------------------------------------------------
+  void Reset();
+
   // ---------------------------------------------------------------------------
   // countTrueLiterals
   //
@@ -146,12 +214,12 @@ class Edge {
  public:
   const bool type;
   bool enabled;
+  // Next to the flags, so a survey of 32 or 16 bits doesn't add padding
+  Survey survey;
 
   Clause* clause;
   Variable* variable;
 
-  double survey;
-
  public:
   // ---------------------------------------------------------------------------
   // Edge constructor
@@ -169,6 +237,13 @@ class Edge {
   // ---------------------------------------------------------------------------
   void Dissable();
 
+  // ---------------------------------------------------------------------------
+  // Reset
+  //
+  // Enable the edge and clear its survey
+  // ---------------------------------------------------------------------------
+  void Reset();
+
   // ---------------------------------------------------------------------------
   // operator<<
   //
@@ -177,11 +252,32 @@ class Edge {
   friend std::ostream& operator<<(std::ostream& os, const Edge* e);
 };
 
+inline Edge* EdgeList::Iterator::operator*() const { return pool + *position; }
+
+inline Edge* EdgeList::operator[](size_t i) const { return pool + first[i]; }
+
+// =============================================================================
+// GraphOrder
+//
+// Order in which the variables and clauses are stored in the graph. The ids
+// of the variables and clauses are always the ones of the DIMACS file.
+// =============================================================================
+enum GraphOrder {
+  ORDER_DIMACS,  // Order of the DIMACS file
+  ORDER_RCM,     // Reverse Cuthill-McKee: neighbour nodes are stored close
+  TOTAL_GRAPH_ORDERS
+};
+
 // =============================================================================
 // FactorGraph
 //
 // Graph representation of a CNF. Must be initialized with the content of a
 // valid DIMACS CNF file.
+//
+// Variables, clauses and edges are stored contiguously in the graph order, so
+// the variables and clauses vectors can be iterated without jumping around
+// the heap. The neighbour edges of all of them are positions in one array,
+// the only part of the graph that never changes, shared with the clones.
 // =============================================================================
 class FactorGraph {
  public:
@@ -195,10 +291,44 @@ class FactorGraph {
   // ---------------------------------------------------------------------------
   // FactorGraph constructor
   //
-  // Build the Variables, Clauses and Edges of the CNF
+  // Build the Variables, Clauses and Edges of the CNF read from a DIMACS
+  // stream (usually a file) and store them in the given order
+  // ---------------------------------------------------------------------------
+  explicit FactorGraph(std::istream& file, GraphOrder order = ORDER_DIMACS);
+
+  // ---------------------------------------------------------------------------
+  // FactorGraph constructor
+  //
+  // Build the graph of a CNF given as DIMACS literals, each clause finished
+  // with a 0. Literals refer to the variables 1..variableIds.size(), and
+  // variableIds are the ids given to them (e.g. the ids of the original CNF
+  // of a simplified formula). Clause ids are their position in the literals
+  // ---------------------------------------------------------------------------
+  FactorGraph(const std::vector<unsigned>& variableIds,
+              const std::vector<int>& literals,
+              GraphOrder order = ORDER_DIMACS);
+  FactorGraph(const FactorGraph&) = delete;
+  FactorGraph& operator=(const FactorGraph&) = delete;
+
+  // ---------------------------------------------------------------------------
+  // Clone
+  //
+  // New graph with the same state as this one (assignment, enabled clauses
+  // and edges, surveys and sub products), e.g. to solve copies of a formula
+  // in parallel. The clone shares the neighbour lists with this graph and
+  // only copies the variables, clauses and edges, without parsing or
+  // allocating a list per node. Both graphs can be modified and deleted
+  // independently. The caller owns the clone
   // ---------------------------------------------------------------------------
-  explicit FactorGraph(std::ifstream& file);
-  ~FactorGraph();
+  FactorGraph* Clone() const;
+
+  // ---------------------------------------------------------------------------
+  // GraphOrderName / ParseGraphOrder
+  //
+  // Names of the graph orders used in the command line options: dimacs, rcm
+  // ---------------------------------------------------------------------------
+  static const char* GraphOrderName(GraphOrder order);
+  static bool ParseGraphOrder(const std::string& name, GraphOrder& order);
 
   // ---------------------------------------------------------------------------
   // Getters
@@ -215,10 +345,41 @@ class FactorGraph {
   // ---------------------------------------------------------------------------
   bool IsSAT() const;
 
+  // ---------------------------------------------------------------------------
+  // Reset
+  //
+  // Restore the graph to the state it had just after being loaded: all
+  // variables unassigned with clean sub products, all clauses and edges
+  // enabled and all surveys set to 0. Allows to run the algorithms multiple
+  // times over the same instance without parsing the DIMACS file again
+  // ---------------------------------------------------------------------------
+  void Reset();
+
+  // ---------------------------------------------------------------------------
+  // GetMemoryUsage
+  //
+  // Bytes used by the variables, clauses, edges and adjacency lists. The
+  // adjacency lists shared with clones are counted in every graph
+  // ---------------------------------------------------------------------------
+  MemoryUsage GetMemoryUsage() const;
+
+  // ---------------------------------------------------------------------------
+  // EstimateMemoryUsage
+  //
+  // Estimate the bytes that a graph with the given size will use once loaded,
+  // assuming clauses of k literals with variables chosen uniformly at random.
+  // The stream version only reads the DIMACS header (p cnf N M)
+  // ---------------------------------------------------------------------------
+  static MemoryUsage EstimateMemoryUsage(unsigned totalVariables,
+                                         unsigned totalClauses, unsigned k = 3);
+  static MemoryUsage EstimateMemoryUsage(std::istream& file, unsigned k = 3);
+
   // ---------------------------------------------------------------------------
   // storeVariableValues
   //
-  // Store the variable values in a file to validatethe formula
+  // Store the variable values in a file to validatethe formula. Values are
+  // written in the order of the variable ids, whatever the graph order is.
+  // Ids missing in the graph are stored as false
   // ---------------------------------------------------------------------------
   bool storeVariableValues(const std::string& filePath);
 
@@ -228,5 +389,26 @@ class FactorGraph {
   // Assigned Variables: N/N - Satisfied Clauses: N/N
   // ---------------------------------------------------------------------------
   friend std::ostream& operator<<(std::ostream& os, FactorGraph* fg);
+
+ private:
+  // Storage of the nodes and edges pointed by the public vectors
+  std::vector<Variable> variablePool;
+  std::vector<Clause> clausePool;
+  std::vector<Edge> edgePool;
+
+  // Neighbour edges of the clauses and the variables, as positions in the
+  // edge pool
+  std::shared_ptr<const std::vector<unsigned>> adjacency;
+
+  FactorGraph() = default;
+
+  // ---------------------------------------------------------------------------
+  // Build
+  //
+  // Create the nodes and edges of a CNF given as DIMACS literals, each clause
+  // finished with a 0
+  // ---------------------------------------------------------------------------
+  void Build(const std::vector<unsigned>& variableIds,
+             const std::vector<int>& literals, GraphOrder order);
 };
 }  // namespace sat
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace sat {
+
+// =============================================================================
+// Generator
+//
+// In-memory random k-CNF generator. Writes DIMACS instances with the same
+// format as libs/cnf-generator/random, so they can be loaded in a FactorGraph
+// without touching the disk.
+// =============================================================================
+class Generator {
+ public:
+  std::mt19937 randomGenerator;
+
+ public:
+  explicit Generator(unsigned seed);
+
+  // ---------------------------------------------------------------------------
+  // RandomKSAT
+  //
+  // Write a formula with N variables and M clauses of k different variables
+  // chosen uniformly at random and negated with probability 1/2
+  // ---------------------------------------------------------------------------
+  void RandomKSAT(std::ostream& os, int N, int M, int k);
+
+  // ---------------------------------------------------------------------------
+  // PlantedKSAT
+  //
+  // Same as RandomKSAT, but every clause is satisfied by a hidden random
+  // assignment, which is stored in solution (solution[i] is the value of the
+  // variable i + 1). The formula is always SAT.
+  // ---------------------------------------------------------------------------
+  void PlantedKSAT(std::ostream& os, int N, int M, int k,
+                   std::vector<bool>& solution);
+
+ private:
+  void writeFormula(std::ostream& os, int N, int M, int k,
+                    const std::vector<bool>* solution);
+};
+
+}  // namespace sat
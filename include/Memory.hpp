@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+
+namespace sat {
+
+// =============================================================================
+// MemoryUsage
+//
+// Bytes used by each part of a FactorGraph and a Solver. Heap allocations
+// include the malloc chunk overhead, so values are close to the real RSS.
+// =============================================================================
+struct MemoryUsage {
+  size_t variables = 0;  // Variable objects and the graph list of them
+  size_t clauses = 0;    // Clause objects and the graph list of them
+  size_t edges = 0;      // Edge objects and the graph list of them
+  size_t adjacency = 0;  // Neighbour edge lists of variables and clauses
+  size_t scratch = 0;    // Temporary vectors and state of the solver
+
+  size_t Total() const;
+
+  MemoryUsage& operator+=(const MemoryUsage& other);
+
+  // ---------------------------------------------------------------------------
+  // operator<<
+  //
+  // One line per part: {part}: {MB}MB
+  // ---------------------------------------------------------------------------
+  friend std::ostream& operator<<(std::ostream& os, const MemoryUsage& usage);
+};
+
+// -----------------------------------------------------------------------------
+// HeapSize
+//
+// Bytes taken in the heap by an allocation of size bytes (glibc malloc: 8 bytes
+// of header, 16 bytes alignment and 32 bytes minimum chunk)
+// -----------------------------------------------------------------------------
+size_t HeapSize(size_t size);
+
+// =============================================================================
+// Memory
+//
+// Helpers to measure the memory used by the process (Linux only). Sizes are
+// in KB. If the information is not available, 0 is returned.
+// =============================================================================
+
+// -----------------------------------------------------------------------------
+// GetPeakRSS
+//
+// Peak resident set size of the process since it started or since the last
+// call to ResetPeakRSS
+// -----------------------------------------------------------------------------
+long GetPeakRSS();
+
+// -----------------------------------------------------------------------------
+// GetCurrentRSS
+//
+// Current resident set size of the process
+// -----------------------------------------------------------------------------
+long GetCurrentRSS();
+
+// -----------------------------------------------------------------------------
+// ResetPeakRSS
+//
+// Set the peak resident set size to the current one, so the peak of a single
+// run can be measured. Returns false if the kernel does not support it
+// -----------------------------------------------------------------------------
+bool ResetPeakRSS();
+
+}  // namespace sat
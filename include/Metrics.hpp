@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+// Project headers
+#include <Configuration.hpp>
+
+namespace sat {
+
+// =============================================================================
+// Phase
+//
+// Phases of the Solver that can be measured. Phases can be nested (e.g. unit
+// propagation runs inside variable fixing), so the time of a phase includes
+// the time of all the phases executed inside it.
+// =============================================================================
+enum Phase {
+  PHASE_SP_SWEEP,
+  PHASE_SUBPRODUCTS,
+  PHASE_BIAS,
+  PHASE_FIX,
+  PHASE_UP,
+  PHASE_IS_SAT,
+  PHASE_WALKSAT_FLIP,
+  TOTAL_PHASES
+};
+
+// =============================================================================
+// Metrics
+//
+// Store how many times each phase has been executed and how many nanoseconds
+// has taken. When disabled, measuring a phase only costs a branch.
+// =============================================================================
+class Metrics {
+ public:
+  bool enabled = false;
+
+  uint64_t calls[TOTAL_PHASES];
+  uint64_t nanoseconds[TOTAL_PHASES];
+
+  // Number of active measures of each phase, used to time only the outermost
+  // call of recursive phases
+  int depth[TOTAL_PHASES];
+
+ public:
+  Metrics();
+
+  // ---------------------------------------------------------------------------
+  // Reset
+  //
+  // Set all counters to 0
+  // ---------------------------------------------------------------------------
+  void Reset();
+
+  // ---------------------------------------------------------------------------
+  // operator+=
+  //
+  // Add the calls and time of other metrics (e.g. of solvers running in other
+  // threads). Times are summed, so they can exceed the wall-clock time
+  // ---------------------------------------------------------------------------
+  Metrics& operator+=(const Metrics& other);
+
+  // ---------------------------------------------------------------------------
+  // PhaseName
+  //
+  // Name of the phase used in the exported files
+  // ---------------------------------------------------------------------------
+  static const char* PhaseName(Phase phase);
+
+  // ---------------------------------------------------------------------------
+  // storeCSV / storeJSON
+  //
+  // Store the counters of all phases in a file
+  // CSV: phase,calls,ns (one row per phase)
+  // JSON: {"phase": {"calls": N, "ns": N}, ...}
+  // ---------------------------------------------------------------------------
+  bool storeCSV(const std::string& filePath) const;
+  bool storeJSON(const std::string& filePath) const;
+
+  // ---------------------------------------------------------------------------
+  // operator<<
+  //
+  // One line per phase: {phase}: {calls} calls - {ms}ms
+  // ---------------------------------------------------------------------------
+  friend std::ostream& operator<<(std::ostream& os, const Metrics& metrics);
+};
+
+// =============================================================================
+// PhaseTimer
+//
+// Measure a phase during the lifetime of the object. Does nothing if the
+// metrics are disabled or the build has no instrumentation.
+// =============================================================================
+class PhaseTimer {
+ public:
+  PhaseTimer(Metrics& metrics, Phase phase) : metrics(metrics), phase(phase) {
+    if (!Configuration::instrumentation || !metrics.enabled) return;
+    metrics.calls[phase]++;
+    if (metrics.depth[phase]++ == 0) begin = std::chrono::steady_clock::now();
+  }
+
+  ~PhaseTimer() { Stop(); }
+
+  // ---------------------------------------------------------------------------
+  // Stop
+  //
+  // Finish the measure before the end of the scope
+  // ---------------------------------------------------------------------------
+  void Stop() {
+    if (!Configuration::instrumentation || !metrics.enabled || stopped)
+      return;
+    stopped = true;
+    if (--metrics.depth[phase] == 0) {
+      std::chrono::steady_clock::time_point end =
+          std::chrono::steady_clock::now();
+      metrics.nanoseconds[phase] +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+              .count();
+    }
+  }
+
+ private:
+  Metrics& metrics;
+  const Phase phase;
+  bool stopped = false;
+  std::chrono::steady_clock::time_point begin;
+};
+
+}  // namespace sat
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+// Project headers
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+namespace sat {
+
+// =============================================================================
+// PortfolioMember
+//
+// Configuration of one SID run of a portfolio and its result in the last
+// Solve. Members differ in the fraction, the decimation schedule, the SP sweep
+// order and the seed (the seed of the portfolio plus the member index)
+// =============================================================================
+struct PortfolioMember {
+  double fraction = 0.01;
+  DecimationSchedule schedule = SCHEDULE_FIXED;
+  SweepOrder sweepOrder = SWEEP_SHUFFLE;
+
+  // Results of the last Solve. Members not started before the portfolio
+  // stopped keep started = false and INDETERMINATE
+  bool started = false;
+  AlgorithmResult result = INDETERMINATE;
+  double seconds = 0.0;
+  int spIterations = 0;
+  int sidIterations = 0;
+};
+
+// =============================================================================
+// Portfolio
+//
+// Solve an instance with several SID configurations at the same time, each
+// one on its own copy of the graph. The members are run by threads workers,
+// in order, and all of them stop as soon as one finds a solution. The
+// portfolio also stops when the budget (wall-clock seconds) is over, and
+// then the result is TIMEOUT.
+//
+// The copies are clones of the graph, which must be as loaded (or reset).
+// The model of the winner is assigned to the graph.
+// =============================================================================
+class Portfolio {
+ public:
+  int threads = 1;
+  double budget = 0.0;  // Seconds for the whole Solve. 0 is no limit
+  std::vector<PortfolioMember> members;
+
+  // Results of the last Solve: member of the result (the first one that
+  // found a solution, or the first member if none did), whether the budget
+  // was over and the wall-clock seconds
+  int winner = -1;
+  bool expired = false;
+  double seconds = 0.0;
+
+ public:
+  // ---------------------------------------------------------------------------
+  // Add
+  //
+  // Add a member with the given configuration
+  // ---------------------------------------------------------------------------
+  void Add(double fraction, DecimationSchedule schedule,
+           SweepOrder sweepOrder);
+
+  // ---------------------------------------------------------------------------
+  // Solve
+  //
+  // Run SID with all the members. configure sets the options of every solver
+  // before the ones of its member. Member m uses the seed + m and the given
+  // stream, so the first member runs the same SID as a single solver with
+  // that seed and stream. Returns the result of the winner
+  // ---------------------------------------------------------------------------
+  AlgorithmResult Solve(FactorGraph* graph, unsigned long seed,
+                        unsigned long stream,
+                        const std::function<void(Solver&)>& configure);
+};
+
+}  // namespace sat
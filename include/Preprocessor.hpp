@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Project headers
+#include <FactorGraph.hpp>
+
+namespace sat {
+
+// =============================================================================
+// Preprocessor
+//
+// Simplify a CNF before running SID. Reads the clauses of a FactorGraph,
+// simplifies them and builds a new, smaller FactorGraph with the remaining
+// clauses. The remaining variables keep their original ids, and the values of
+// the eliminated variables are recorded, so a model of the simplified graph
+// can be extended to a model of the original CNF.
+//
+// Simplifications:
+// - Removal of duplicate literals and tautological clauses
+// - Unit propagation
+// - Pure literal elimination
+// - Bounded variable elimination (optional)
+// - Removal of duplicate clauses
+// =============================================================================
+class Preprocessor {
+ public:
+  // Bounded variable elimination: a variable is replaced by all the
+  // resolvents of its clauses only if they are not more than the clauses
+  // removed and none of them is longer than maxResolventSize. Variables with
+  // more than maxOccurrences clauses are not tried
+  bool variableElimination = false;
+  unsigned maxResolventSize = 20;
+  unsigned maxOccurrences = 16;
+
+  // Statistics of the last Run
+  unsigned duplicateLiterals = 0;
+  unsigned tautologies = 0;
+  unsigned unitLiterals = 0;
+  unsigned pureLiterals = 0;
+  unsigned eliminatedVariables = 0;
+  unsigned duplicateClauses = 0;
+
+ public:
+  // ---------------------------------------------------------------------------
+  // Preprocessor constructor
+  //
+  // Copy the clauses of the graph. The graph is not modified and can be
+  // deleted once the preprocessor is built
+  // ---------------------------------------------------------------------------
+  explicit Preprocessor(const FactorGraph& graph);
+
+  // ---------------------------------------------------------------------------
+  // Run
+  //
+  // Apply all the simplifications until none of them changes the formula.
+  // Returns false if an empty clause is found (the CNF is UNSAT). Running it
+  // again over a simplified formula doesn't change it
+  // ---------------------------------------------------------------------------
+  bool Run();
+
+  // ---------------------------------------------------------------------------
+  // BuildGraph
+  //
+  // New graph with the remaining clauses and the variables that appear in
+  // them. The caller owns the graph
+  // ---------------------------------------------------------------------------
+  FactorGraph* BuildGraph(GraphOrder order = ORDER_DIMACS) const;
+
+  // ---------------------------------------------------------------------------
+  // ExtendModel
+  //
+  // Values of all the variables of the original CNF, by id - 1, given the
+  // values of the variables of the simplified graph. Variables that were
+  // removed without a value are set to false
+  // ---------------------------------------------------------------------------
+  std::vector<bool> ExtendModel(const FactorGraph& graph) const;
+
+  // ---------------------------------------------------------------------------
+  // storeModel
+  //
+  // Store the extended model in a file with the format of
+  // FactorGraph::storeVariableValues, to validate the original formula
+  // ---------------------------------------------------------------------------
+  bool storeModel(const FactorGraph& graph, const std::string& filePath) const;
+
+  // ---------------------------------------------------------------------------
+  // Getters
+  //
+  // Size of the original and the simplified formula
+  // ---------------------------------------------------------------------------
+  unsigned GetOriginalVariables() const { return totalVariables; }
+  unsigned GetOriginalClauses() const { return originalClauses; }
+  unsigned GetRemainingVariables() const;
+  unsigned GetRemainingClauses() const;
+
+  // ---------------------------------------------------------------------------
+  // operator<<
+  //
+  // Remaining variables and clauses and the statistics of every
+  // simplification
+  // ---------------------------------------------------------------------------
+  friend std::ostream& operator<<(std::ostream& os, const Preprocessor& pre);
+
+ private:
+  unsigned totalVariables;
+  unsigned originalClauses;
+
+  // Clauses with their literals sorted by variable. Removed clauses are kept
+  // in the vector but not counted in literalCount
+  std::vector<std::vector<int>> clauses;
+  std::vector<bool> removed;
+
+  // Clauses where every literal appears, by literal index. May contain
+  // clauses already removed or that no longer contain the literal
+  std::vector<std::vector<unsigned>> occurrences;
+  // Number of active clauses that contain every literal, by literal index
+  std::vector<unsigned> literalCount;
+
+  // Value of every variable by id - 1: 1 true, -1 false, 0 not fixed
+  std::vector<signed char> values;
+  std::vector<bool> eliminated;
+
+  // Eliminated variables, in elimination order, with the clauses where they
+  // appeared as a positive literal. While extending a model in reverse order,
+  // the variable is true only if one of these clauses needs it
+  std::vector<std::pair<unsigned, std::vector<std::vector<int>>>>
+      eliminationStack;
+
+  // Literals waiting to be fixed and if they are pure (or unit otherwise)
+  std::vector<std::pair<int, bool>> pending;
+
+  // Literal index: 2 * (id - 1) for positive literals, + 1 for negative ones
+  static inline unsigned literalIndex(int literal) {
+    return literal > 0 ? 2 * (literal - 1) : 2 * (-literal - 1) + 1;
+  }
+
+  // Order of the literals in the clauses: by variable, negative first
+  static inline bool literalLess(int a, int b) {
+    return std::abs(a) < std::abs(b) || (std::abs(a) == std::abs(b) && a < b);
+  }
+
+  void normalizeClauses();
+  bool propagate();
+  bool fixLiteral(int literal);
+  void removeClause(unsigned c);
+  bool addClause(const std::vector<int>& literals);
+  std::vector<unsigned> activeOccurrences(int literal) const;
+  bool resolve(const std::vector<int>& positive,
+               const std::vector<int>& negative, unsigned id,
+               std::vector<int>& resolvent) const;
+  bool boundedResolvents(unsigned id,
+                         std::vector<std::vector<int>>& resolvents) const;
+  bool eliminateVariables();
+  void removeDuplicateClauses();
+};
+
+}  // namespace sat
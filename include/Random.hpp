@@ -0,0 +1,242 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace sat {
+
+// =============================================================================
+// Random number generation
+//
+// Fast engines for the hot loops of the solver. Both engines satisfy the
+// UniformRandomBitGenerator requirements (can be used with the std
+// distributions) and produce 64 bits per call.
+//
+// Every engine is initialized with a seed and a stream. Different streams of
+// the same seed are independent sequences, so each thread or instance can use
+// its own reproducible stream.
+// =============================================================================
+
+// -----------------------------------------------------------------------------
+// SplitMix64
+//
+// Used to expand a 64 bits seed into the state of the engines
+// -----------------------------------------------------------------------------
+inline uint64_t SplitMix64(uint64_t& x) {
+  uint64_t z = (x += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+// =============================================================================
+// Xoshiro256PlusPlus
+//
+// xoshiro256++ generator (Blackman & Vigna). 256 bits of state and period
+// 2^256 - 1. Streams are separated by jumps of 2^128 steps.
+// =============================================================================
+class Xoshiro256PlusPlus {
+ public:
+  typedef uint64_t result_type;
+
+  uint64_t state[4];
+
+ public:
+  explicit Xoshiro256PlusPlus(uint64_t seed = 0, uint64_t stream = 0) {
+    this->seed(seed, stream);
+  }
+
+  void seed(uint64_t seed, uint64_t stream = 0) {
+    for (int i = 0; i < 4; i++) state[i] = SplitMix64(seed);
+    for (uint64_t i = 0; i < stream; i++) jump();
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  inline result_type operator()() {
+    const uint64_t result = rotl(state[0] + state[3], 23) + state[0];
+    const uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+  // jump
+  //
+  // Equivalent to 2^128 calls to operator()
+  // ---------------------------------------------------------------------------
+  void jump() {
+    static const uint64_t JUMP[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+                                    0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+
+    uint64_t s[4] = {0, 0, 0, 0};
+    for (uint64_t jump : JUMP) {
+      for (int b = 0; b < 64; b++) {
+        if (jump & ((uint64_t)1 << b)) {
+          for (int i = 0; i < 4; i++) s[i] ^= state[i];
+        }
+        (*this)();
+      }
+    }
+    for (int i = 0; i < 4; i++) state[i] = s[i];
+  }
+
+ private:
+  static inline uint64_t rotl(const uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+};
+
+// =============================================================================
+// Philox4x32
+//
+// Philox4x32-10 counter-based generator (Salmon et al., Random123). The output
+// is a bijection of a 128 bits counter under a 64 bits key, so there is no
+// state apart from the counter. The key is the seed, the high half of the
+// counter is the stream and the low half is the position in the stream.
+// =============================================================================
+class Philox4x32 {
+ public:
+  typedef uint64_t result_type;
+
+  uint32_t key[2];
+  uint32_t counter[4];
+
+ public:
+  explicit Philox4x32(uint64_t seed = 0, uint64_t stream = 0) {
+    this->seed(seed, stream);
+  }
+
+  void seed(uint64_t seed, uint64_t stream = 0) {
+    key[0] = (uint32_t)seed;
+    key[1] = (uint32_t)(seed >> 32);
+    counter[0] = 0;
+    counter[1] = 0;
+    counter[2] = (uint32_t)stream;
+    counter[3] = (uint32_t)(stream >> 32);
+    position = 2;
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  inline result_type operator()() {
+    if (position == 2) {
+      Block(counter, key, output);
+      if (++counter[0] == 0) counter[1]++;
+      position = 0;
+    }
+    uint64_t result = ((uint64_t)output[2 * position + 1] << 32) |
+                      output[2 * position];
+    position++;
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Block
+  //
+  // Compute the 4 random words of a counter with 10 rounds of Philox
+  // ---------------------------------------------------------------------------
+  static void Block(const uint32_t ctr[4], const uint32_t k[2],
+                    uint32_t out[4]) {
+    const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = k[0], k1 = k[1];
+    for (int round = 0; round < 10; round++) {
+      if (round > 0) {
+        k0 += W0;
+        k1 += W1;
+      }
+      uint64_t p0 = (uint64_t)M0 * c0;
+      uint64_t p1 = (uint64_t)M1 * c2;
+      uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+      uint32_t n1 = (uint32_t)p1;
+      uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+      uint32_t n3 = (uint32_t)p0;
+      c0 = n0;
+      c1 = n1;
+      c2 = n2;
+      c3 = n3;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+  }
+
+ private:
+  uint32_t output[4];
+  int position;
+};
+
+// -----------------------------------------------------------------------------
+// RandomEngine
+//
+// Engine used by the solver. xoshiro256++ by default, Philox if compiled with
+// -DSAT_RNG_PHILOX
+// -----------------------------------------------------------------------------
+#ifdef SAT_RNG_PHILOX
+typedef Philox4x32 RandomEngine;
+#else
+typedef Xoshiro256PlusPlus RandomEngine;
+#endif
+
+// -----------------------------------------------------------------------------
+// RandomBelow
+//
+// Random integer in [0, n) using a multiply-shift reduction of the 32 high
+// bits (Lemire). Avoids the division of the modulo reduction, with a bias of
+// at most n / 2^32, negligible for the sizes used by the solver
+// -----------------------------------------------------------------------------
+template <typename Engine>
+inline uint32_t RandomBelow(Engine& engine, uint32_t n) {
+  return (uint32_t)(((engine() >> 32) * (uint64_t)n) >> 32);
+}
+
+// -----------------------------------------------------------------------------
+// RandomReal01
+//
+// Random double in [0, 1) from the 53 high bits
+// -----------------------------------------------------------------------------
+template <typename Engine>
+inline double RandomReal01(Engine& engine) {
+  return (engine() >> 11) * 0x1.0p-53;
+}
+
+// -----------------------------------------------------------------------------
+// RandomBool
+// -----------------------------------------------------------------------------
+template <typename Engine>
+inline bool RandomBool(Engine& engine) {
+  return engine() >> 63;
+}
+
+// -----------------------------------------------------------------------------
+// Shuffle
+//
+// Fisher-Yates shuffle using RandomBelow
+// -----------------------------------------------------------------------------
+template <typename Iterator, typename Engine>
+void Shuffle(Iterator first, Iterator last, Engine& engine) {
+  uint32_t size = last - first;
+  for (uint32_t i = size; i > 1; i--) {
+    std::swap(first[i - 1], first[RandomBelow(engine, i)]);
+  }
+}
+
+}  // namespace sat
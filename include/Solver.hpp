@@ -1,16 +1,21 @@
 #pragma once
 
+#include <Anderson.hpp>
+#include <Configuration.hpp>
 #include <FactorGraph.hpp>
+#include <Metrics.hpp>
+#include <Random.hpp>
+#include <Trace.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <random>
+#include <vector>
 
 using namespace std;
 
 namespace sat {
 
-// This constant is to ensure correct comparsion of doubles when checking
-// if a number is 0. All numbers below 1.0e-16 are considered 0.
-#define ZERO_EPSILON (1.0e-16)
-
 enum AlgorithmResult {
   CONVERGE,
   UNCONVERGE,
@@ -18,9 +23,46 @@ enum AlgorithmResult {
   CONTRADICTION,
   SAT,
   INDETERMINATE,
+  TIMEOUT,  // The deadline of the solver passed before a result
   WALKSAT  // TODO remove when walksat is implemented
 };
 
+// Order in which the clauses are updated in every SP iteration. All the
+// orders except SWEEP_SHUFFLE keep most of the sweep in the graph order, so
+// neighbour clauses are updated close in time and memory
+enum SweepOrder {
+  SWEEP_SHUFFLE,         // Full shuffle of the clauses every iteration
+  SWEEP_BLOCK_SHUFFLE,   // Shuffle of the order of blocks of clauses
+  SWEEP_PERMUTATIONS,    // Rotate among permutations computed once per SP
+  SWEEP_RANDOM_OFFSET,   // Graph order from a random offset and direction
+  TOTAL_SWEEP_ORDERS
+};
+
+// Number of variables fixed in every decimation round
+enum DecimationSchedule {
+  SCHEDULE_FIXED,     // The SID fraction of the variables
+  SCHEDULE_ADAPTIVE,  // The polarized variables, between two fractions
+  TOTAL_SCHEDULES
+};
+
+// =============================================================================
+// SolverProgress
+//
+// State of a running SID passed to the progress callback of the solver. In
+// WalkSAT, the variables and clauses are the ones of the subformula, and while
+// the components are solved they are the ones of the component
+// =============================================================================
+struct SolverProgress {
+  int component = -1;                // Task of the components, -1 if none
+  int round = 0;                     // SID round
+  unsigned unassignedVariables = 0;  // Variables not fixed by the decimation
+  unsigned enabledClauses = 0;       // Clauses not satisfied yet
+  int lastSPIterations = 0;          // Iterations of the last SP call
+  double maxSurveyDiff = 0.0;        // Of the last SP sweep (0 before it)
+  int walksatFlips = 0;              // WalkSAT flips of the SID so far
+  int unsatClauses = -1;             // Of the WalkSAT try, -1 out of WalkSAT
+};
+
 // =============================================================================
 // Solver
 //
@@ -31,44 +73,302 @@ class Solver {
   // Random number generator
   random_device rd;
   unsigned long initialSeed;
-  mt19937 randomGenerator;
-  uniform_int_distribution<> randomBoolUD;
-  uniform_real_distribution<> randomReal01UD;
+  unsigned long stream;
+  RandomEngine randomGenerator;
 
   // Factor Graph
-  FactorGraph* fg;
+  FactorGraph* fg = nullptr;
   int N;
   double alpha;
 
   // Algorithm parameters
-  double sidFraction;
+  double sidFraction = 0.01;
+
+  // Paramagnetic state: the average max bias of the unassigned variables is
+  // below paramagneticState, and walksat is called. The sum of the max
+  // biases is kept by the solver, so the check is O(1). With
+  // spParamagneticCheck, the sum is updated every time SP changes the
+  // subproducts of a variable and the check is done after every SP
+  // iteration, so walksat is called without waiting for SP to converge.
+  // Otherwise the sum is only rebuilt when SP converges
   double paramagneticState = 0.01;
+  bool spParamagneticCheck = false;
+
+  // With SCHEDULE_ADAPTIVE, every round fixes the variables with a bias
+  // |Hp - Hm| of at least schedulePolarization. If the last SP call needed
+  // more than scheduleIterations iterations, the number is reduced in the
+  // same proportion. The result is kept between minFraction and the SID
+  // fraction of the variables, so the SID fraction is an upper bound
+  DecimationSchedule schedule = SCHEDULE_FIXED;
+  double minFraction = 0.00125;
+  double schedulePolarization = 0.95;
+  int scheduleIterations = 30;
 
   int spMaxIt = 1000;
   double spEpsilon = 0.001;
 
+  // Damping: every new survey is mixed with the previous one, keeping
+  // spDamping of the previous value. 0 is the plain SP update
+  double spDamping = 0.0;
+
+  // Oscillation detector. If the max survey difference of an SP call has not
+  // reached a new minimum in the last spStallWindow iterations, SP is
+  // stalled: the damping is raised by spDampingStep up to spMaxDamping, and
+  // if it's already at spMaxDamping SP is aborted (UNCONVERGE). 0 disables it
+  int spStallWindow = 0;
+  double spDampingStep = 0.2;
+  double spMaxDamping = 0.8;
+
+  // Anderson acceleration of SP: after every sweep the surveys are
+  // extrapolated from the last spAndersonDepth sweeps. If the sweep after an
+  // extrapolation has a larger max difference than the one before it, the
+  // surveys go back to the plain sweep and the history is restarted. The
+  // sweep order is drawn once per SP call, so every sweep is the same map.
+  // After spAndersonFallbacks reverted extrapolations the rest of the call
+  // uses plain sweeps. 0 disables it
+  int spAndersonDepth = 0;
+  int spAndersonFallbacks = 4;
+  SweepOrder sweepOrder = SWEEP_SHUFFLE;
+  int sweepBlockSize = 256;   // Clauses per block of SWEEP_BLOCK_SHUFFLE
+  int sweepPermutations = 4;  // Permutations of SWEEP_PERMUTATIONS
+
+  // Connected components of the formula (unassigned variables and enabled
+  // clauses). If enabled, they are checked when SID starts and every
+  // componentInterval rounds, and if the formula is split, every component
+  // is solved apart by its own solver. Components with less than
+  // componentMinVariables variables are solved together
+  bool components = false;
+  int componentInterval = 10;
+  int componentMinVariables = 100;
+
+  // Threads used to solve the components and to evaluate the variables in
+  // the decimation in parallel
+  int threads = 1;
+
+  // Cancellation flag shared with other threads (e.g. the other solvers of a
+  // portfolio). Once it's true, SID returns INDETERMINATE at the next SID
+  // round, block of clauses of an SP sweep, variable fixed by the
+  // decimation or WalkSAT flip. Not checked if null
+  const atomic<bool>* cancel = nullptr;
+
+  // Wall-clock deadline of SID, checked at the same points as cancel. Once
+  // it has passed, SID returns TIMEOUT. No deadline by default (the clock is
+  // not read)
+  chrono::steady_clock::time_point deadline =
+      chrono::steady_clock::time_point::max();
+
   int wsMaxTries = 10;
   int wsMaxFlips = 100;
   double wsNoise = 0.57;
 
+  // Progress callback, called from the thread running SID at the start of
+  // every SID round and every progressFlips WalkSAT flips (0: not in
+  // WalkSAT). It can read GetBestAssignment and stop the run with the cancel
+  // flag. Not called if empty. The solvers of the components call it from
+  // their threads, one at a time, with the rounds and flips of this solver
+  // added. Meanwhile GetBestAssignment only has the assignment from before
+  // the split, and the ones of the components are merged when all finish
+  function<void(const SolverProgress&)> progress;
+  int progressFlips = 10000;
+
+  // Keep a copy of the WalkSAT assignment with the fewest unsat clauses for
+  // GetBestAssignment. Every new minimum copies the assignment, so it's off
+  // by default and GetBestAssignment returns the current one
+  bool keepBestAssignment = false;
+
   // Metrics
   int totalSPIterations = 0;
   int totalSIDIterations = 0;
+  int totalWSFlips = 0;
+  int totalComponents = 0;  // Components solved apart
+  int lastSPIterations = 0;  // Iterations of the last SP call
+  int totalSPStalls = 0;     // Times SP was found stalled
+  int totalSPAborts = 0;     // SP calls aborted while stalled
+  int totalSPExtrapolations = 0;  // Anderson steps kept
+  int totalSPFallbacks = 0;       // Anderson steps reverted
+  int totalAssignments = 0;  // Variables fixed by decimation (not by UP)
+
+  // Time and calls of each phase of the last SID execution. Disabled by
+  // default, set metrics.enabled to true to measure
+  Metrics metrics;
+
+  // Timeline of the SID execution (SP calls, decimation rounds, UP cascades
+  // and WalkSAT tries). Only recorded if not null
+  Trace* trace = nullptr;
 
  public:
-  // inline void setSeed(int seed) { _randomGenerator.seed(seed); }
-  inline bool getRandomBool() { return randomBoolUD(randomGenerator); }
-  inline double getRandomReal01() { return randomReal01UD(randomGenerator); }
+  inline bool getRandomBool() { return RandomBool(randomGenerator); }
+  inline double getRandomReal01() { return RandomReal01(randomGenerator); }
+  inline int getRandomInt(int n) { return RandomBelow(randomGenerator, n); }
+
+  // ---------------------------------------------------------------------------
+  // Solver constructor
+  //
+  // If seed = 0, a random seed is used. Solvers with the same seed and
+  // different stream (e.g. one per thread) get independent random sequences
+  // ---------------------------------------------------------------------------
+  explicit Solver(int N, double a, int seed, unsigned long stream = 0);
+
+  // ---------------------------------------------------------------------------
+  // setSeed
+  //
+  // Restart the random sequence, e.g. to make the result of each instance
+  // reproducible regardless of the instances solved before
+  // ---------------------------------------------------------------------------
+  void setSeed(unsigned long seed, unsigned long stream = 0);
 
-  explicit Solver(int N, double a, int seed);
+  // ---------------------------------------------------------------------------
+  // setTimeLimit
+  //
+  // Set the deadline to the given seconds from now. 0 or less removes it
+  // ---------------------------------------------------------------------------
+  void setTimeLimit(double seconds);
+
+  // ---------------------------------------------------------------------------
+  // copyOptions
+  //
+  // Copy the options of the algorithms (fraction, SP, decimation, components,
+  // threads and walksat) from another solver. The seed, the metrics and the
+  // hooks of the run (cancel, deadline, progress, trace) are not copied
+  // ---------------------------------------------------------------------------
+  void copyOptions(const Solver& other);
 
   AlgorithmResult SID(FactorGraph* graph, double fraction);
 
+  // SID with the fraction of the options (sidFraction)
+  AlgorithmResult SID(FactorGraph* graph) { return SID(graph, sidFraction); }
+
+  // ---------------------------------------------------------------------------
+  // GetAverageMaxBias
+  //
+  // Average max bias of the unassigned variables with the subproducts of the
+  // last SP call. Variables assigned since then are not counted
+  // ---------------------------------------------------------------------------
+  double GetAverageMaxBias() const;
+
+  // ---------------------------------------------------------------------------
+  // GetBestAssignment
+  //
+  // Best assignment of the running (from the progress callback) or the last
+  // SID, as the DIMACS literals of the assigned variables. It's the partial
+  // assignment of the decimation until WalkSAT starts, and then the complete
+  // assignment of WalkSAT with the fewest unsat clauses (the current one
+  // without keepBestAssignment). Returns the clauses it doesn't satisfy with
+  // all their variables assigned
+  // ---------------------------------------------------------------------------
+  int GetBestAssignment(vector<int>& literals) const;
+
+  // ---------------------------------------------------------------------------
+  // ResultName
+  //
+  // Name of an algorithm result as printed in the reports: SAT, UNCONVERGE,
+  // CONTRADICTION, INDETERMINATE, TIMEOUT...
+  // ---------------------------------------------------------------------------
+  static const char* ResultName(AlgorithmResult result);
+
+  // ---------------------------------------------------------------------------
+  // SweepOrderName / ParseSweepOrder
+  //
+  // Names of the sweep orders used in the command line options:
+  // shuffle, block, permutations, offset
+  // ---------------------------------------------------------------------------
+  static const char* SweepOrderName(SweepOrder order);
+  static bool ParseSweepOrder(const string& name, SweepOrder& order);
+
+  // ---------------------------------------------------------------------------
+  // ScheduleName / ParseSchedule
+  //
+  // Names of the decimation schedules: fixed, adaptive
+  // ---------------------------------------------------------------------------
+  static const char* ScheduleName(DecimationSchedule schedule);
+  static bool ParseSchedule(const string& name, DecimationSchedule& schedule);
+
+  // ---------------------------------------------------------------------------
+  // storeOptions / loadOptions
+  //
+  // Store or load the tunable options in a file, one "name=value" per line
+  // with the names of the experiment options: fraction, sp-max-it,
+  // sp-epsilon, paramagnetic, ws-max-tries, ws-max-flips, ws-noise. Empty
+  // lines and lines starting with '#' are ignored. Options not in the file
+  // keep their value. Fails if the file can't be opened or has an unknown
+  // name or invalid value (the options read before it are kept)
+  // ---------------------------------------------------------------------------
+  bool storeOptions(const string& filePath) const;
+  bool loadOptions(const string& filePath);
+
+  // Bytes used by the solver scratch (solver state and the largest set of
+  // temporary vectors alive at the same time) when solving the current graph
+  // or a graph of the given size. Temporary vectors only exist during SID, so
+  // this is an upper bound of the solver overhead over the graph.
+  // sweepPermutations is the number of clause permutations stored by SP
+  // (only used by SWEEP_PERMUTATIONS)
+  MemoryUsage GetMemoryUsage() const;
+  static MemoryUsage EstimateMemoryUsage(unsigned totalVariables,
+                                         unsigned totalClauses,
+                                         unsigned sweepPermutations = 0);
+
  private:
+  // The benchmarks measure the private steps of the algorithms in isolation
+  friend class SolverBenchmark;
+
+  // Paramagnetic state tracker: sum of the max bias of the unassigned
+  // variables and how many of them there are. Rebuilt with the subproducts
+  // at the start of every SP call and updated when a variable is assigned
+  double sumMaxBias = 0.0;
+  unsigned trackedVariables = 0;
+
+  // Minimum variables fixed in every round with SCHEDULE_ADAPTIVE
+  int minAssignments = 1;
+
+  // Damping of the running SP call
+  double damping = 0.0;
+
+  // Max survey difference of the last SP sweep, for the progress callback
+  double lastSurveyDiff = 0.0;
+
+  // Copy of the best WalkSAT assignment (with keepBestAssignment) and its
+  // unsat clauses, -1 if there is none
+  vector<int> bestLiterals;
+  int bestUnsatClauses = -1;
+
+  // Why the running SID was stopped: INDETERMINATE if cancelled, TIMEOUT if
+  // the deadline passed. CONVERGE while it's not stopped
+  AlgorithmResult interruption = CONVERGE;
+
+  // Check the cancellation flag and the deadline. Once it's true, it keeps
+  // being true until the next SID
+  bool interrupted();
+
+  void reportProgress(unsigned unassignedVariables, unsigned enabledClauses,
+                      int unsatClauses);
+  static int countUnsatClauses(const FactorGraph* graph);
+  void keepAssignment(int unsatClauses);
+
   AlgorithmResult walksat();
   AlgorithmResult surveyPropagation();
+  void readSurveys(const vector<Edge*>& edges, vector<double>& surveys) const;
+  void writeSurveys(const vector<Edge*>& edges, const vector<double>& surveys);
+  void orderSweep(const vector<Clause*>& clauses, vector<Clause*>& sweep,
+                  const vector<vector<Clause*>>& permutations, int iteration);
+  AlgorithmResult decimate(int assignFraction);
+  bool solveComponents(AlgorithmResult& result);
+  unsigned evaluateVariables(unsigned totalCandidates,
+                             vector<Variable*>& candidates);
+  void selectUnassigned(unsigned totalCandidates,
+                        vector<Variable*>& candidates);
+  int scheduleAssignments(int assignFraction, unsigned polarized);
+  void parallelFor(unsigned totalTasks,
+                   const std::function<void(unsigned)>& task);
+  static unsigned clauseArity(const vector<Clause*>& clauses);
+  double sweepSurveys(const vector<Clause*>& clauses, unsigned arity);
+  template <class Policy>
+  double sweepSurveys(const vector<Clause*>& clauses);
+  template <class Policy>
   double updateSurveys(Clause* clause);
   void computeSubProducts();
+  void trackVariable(Variable* var);
+  void trackAllVariables();
+  bool isParamagnetic() const;
   void evaluateVar(Variable* var);
   bool assignVariable(Variable* var, bool value);
   bool cleanGraph(Variable* var);
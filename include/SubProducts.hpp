@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace sat {
+
+// This constant is to ensure correct comparsion of doubles when checking
+// if a number is 0. All numbers below 1.0e-16 are considered 0.
+#define ZERO_EPSILON (1.0e-16)
+
+// =============================================================================
+// Survey arithmetic
+//
+// The sub products of a variable are P(1 - survey) over its positive or
+// negative edges. SP needs the whole product (for the other sign of the
+// variable) and the product without one edge (cavity of the edge), and
+// changes one factor every time a survey is updated.
+//
+// Both arithmetics keep the product of a sign in a double and a counter of
+// factors that are 0, and are used through the same static functions:
+//  - Reset: empty product
+//  - Add: multiply the product by (1 - survey)
+//  - Update: replace the factor of the survey old by the one of survey new
+//  - Product: the whole product
+//  - Without: the product without the factor of survey
+//
+// The solver uses the arithmetic of the Configuration (see Configuration.hpp).
+// =============================================================================
+
+// -----------------------------------------------------------------------------
+// FastLog / FastExp
+//
+// Branch-free approximations of log and exp, with a relative error below
+// 1e-9 (FastLog for x > 0, FastExp for x >= -708)
+// -----------------------------------------------------------------------------
+inline double FastLog(double x) {
+  uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  // x = mantissa * 2^exponent with mantissa in [sqrt(1/2), sqrt(2))
+  int64_t exponent = (int64_t)((bits >> 52) & 0x7ff) - 1023;
+  bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+  double mantissa;
+  std::memcpy(&mantissa, &bits, sizeof(mantissa));
+  bool high = mantissa > 1.4142135623730951;
+  mantissa = high ? mantissa * 0.5 : mantissa;
+  exponent += high;
+
+  // log(mantissa) = 2 atanh(t) with |t| < 0.172
+  double t = (mantissa - 1.0) / (mantissa + 1.0);
+  double t2 = t * t;
+  double series =
+      1.0 +
+      t2 * (1.0 / 3 +
+            t2 * (1.0 / 5 + t2 * (1.0 / 7 + t2 * (1.0 / 9 + t2 / 11))));
+  return 2.0 * t * series + exponent * 0.6931471805599453;
+}
+
+inline double FastExp(double x) {
+  x = std::max(x, -708.0);
+  // x = (n + f) log(2) with f in [-1/2, 1/2]
+  double n = (double)(int64_t)(x * 1.4426950408889634 + (x < 0 ? -.5 : .5));
+  double r = x - n * 0.6931471805599453;
+
+  // exp(r) with |r| < 0.347, Taylor series up to r^10 / 10!
+  double series = 1.0;
+  for (int k = 10; k > 0; k--) series = 1.0 + series * r / k;
+  uint64_t bits = (uint64_t)((int64_t)n + 1023) << 52;
+  double scale;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return series * scale;
+}
+
+// =============================================================================
+// LinearSubProducts
+//
+// Products of the (1 - survey) factors. A factor below ZERO_EPSILON (survey 1)
+// is not multiplied but counted in zeros, so it can be removed again
+// =============================================================================
+struct LinearSubProducts {
+  static const char* Name() { return "linear"; }
+
+  static inline void Reset(double& product, int& zeros) {
+    product = 1.0;
+    zeros = 0;
+  }
+
+  static inline void Add(double& product, int& zeros, double survey) {
+    if (1.0 - survey > ZERO_EPSILON)
+      product *= 1.0 - survey;
+    else
+      zeros++;
+  }
+
+  static inline void Update(double& product, int& zeros, double oldSurvey,
+                            double newSurvey) {
+    // If previous survey != 1 (with an epsilon margin)
+    if (1.0 - oldSurvey > ZERO_EPSILON) {
+      // If new survey != 1, update the sub product with the difference
+      if (1.0 - newSurvey > ZERO_EPSILON)
+        product *= (1.0 - newSurvey) / (1.0 - oldSurvey);
+      // If new survey == 1, remove the old survey from the sub product and
+      // keep track of the new survey == 1
+      else {
+        product /= 1.0 - oldSurvey;
+        zeros++;
+      }
+    }
+    // If previous survey == 1 and new survey != 1, update the sub product.
+    // If both are 1 there is nothing to do
+    else if (1.0 - newSurvey > ZERO_EPSILON) {
+      product *= 1.0 - newSurvey;
+      zeros--;
+    }
+  }
+
+  static inline double Product(double product, int zeros) {
+    return zeros ? 0.0 : product;
+  }
+
+  static inline double Without(double product, int zeros, double survey) {
+    if (zeros == 0) return product / (1.0 - survey);
+    // The only factor 0 is the one removed
+    if (zeros == 1 && 1.0 - survey < ZERO_EPSILON) return product;
+    return 0.0;
+  }
+};
+
+// =============================================================================
+// LogSubProducts
+//
+// Sums of log(1 - survey), without branches. A survey of 1 is a factor of
+// ZERO_EPSILON, so zeros is always 0 and the products are never exactly 0.
+// Every update adds the difference of two logs of the same function, so the
+// sum doesn't drift from the sum of the logs of the current surveys
+// =============================================================================
+struct LogSubProducts {
+  static const char* Name() { return "log"; }
+
+  static inline double Log1m(double survey) {
+    return FastLog(std::max(1.0 - survey, ZERO_EPSILON));
+  }
+
+  static inline void Reset(double& product, int& zeros) {
+    product = 0.0;
+    zeros = 0;
+  }
+
+  static inline void Add(double& product, int&, double survey) {
+    product += Log1m(survey);
+  }
+
+  static inline void Update(double& product, int&, double oldSurvey,
+                            double newSurvey) {
+    product += Log1m(newSurvey) - Log1m(oldSurvey);
+  }
+
+  static inline double Product(double product, int) {
+    return FastExp(product);
+  }
+
+  static inline double Without(double product, int, double survey) {
+    return FastExp(product - Log1m(survey));
+  }
+};
+
+}  // namespace sat
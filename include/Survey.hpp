@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace sat {
+
+// =============================================================================
+// Survey storage
+//
+// Types of the survey stored in every edge: double, float or FixedSurvey. The
+// type is chosen by the Configuration (see Configuration.hpp). The surveys are
+// always computed with doubles, only the stored value has less precision.
+// =============================================================================
+
+// -----------------------------------------------------------------------------
+// FixedSurvey
+//
+// Survey in [0, 1] stored as a 16 bits fixed point number, with a resolution
+// of 1 / 65535 (1.5e-5). Values out of [0, 1] are clamped
+// -----------------------------------------------------------------------------
+class FixedSurvey {
+ public:
+  FixedSurvey(double value = 0.0)
+      : bits((uint16_t)(std::min(std::max(value, 0.0), 1.0) * 65535 + 0.5)) {}
+
+  operator double() const { return bits * (1.0 / 65535); }
+
+ private:
+  uint16_t bits;
+};
+
+// -----------------------------------------------------------------------------
+// SurveyPrecision
+//
+// Name of every survey type, for the logs
+// -----------------------------------------------------------------------------
+template <typename Survey>
+struct SurveyPrecision;
+
+template <>
+struct SurveyPrecision<double> {
+  static const char* Name() { return "double"; }
+};
+
+template <>
+struct SurveyPrecision<float> {
+  static const char* Name() { return "float"; }
+};
+
+template <>
+struct SurveyPrecision<FixedSurvey> {
+  static const char* Name() { return "fixed16"; }
+};
+
+}  // namespace sat
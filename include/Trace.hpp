@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Project headers
+#include <Configuration.hpp>
+
+namespace sat {
+
+// =============================================================================
+// TraceEvent
+//
+// Event of the Chrome trace-event format. Can be a span (phase 'X') with a
+// begin timestamp and a duration, or a counter sample (phase 'C').
+// Timestamps are microseconds since the creation of the trace.
+// =============================================================================
+struct TraceEvent {
+  const char* name;
+  char phase;
+  double ts;
+  double dur;
+  std::vector<std::pair<const char*, double>> args;
+};
+
+// =============================================================================
+// Trace
+//
+// Timeline of a solver execution. Stores the events in memory and exports them
+// as a Chrome trace-event JSON file that can be opened with chrome://tracing
+// or https://ui.perfetto.dev
+// =============================================================================
+class Trace {
+ public:
+  std::vector<TraceEvent> events;
+
+ public:
+  Trace();
+
+  // ---------------------------------------------------------------------------
+  // Now
+  //
+  // Microseconds elapsed since the creation (or last Clear) of the trace
+  // ---------------------------------------------------------------------------
+  double Now() const;
+
+  // ---------------------------------------------------------------------------
+  // AddSpan
+  //
+  // Add a span that started at begin and finishes now
+  // ---------------------------------------------------------------------------
+  void AddSpan(const char* name, double begin,
+               std::vector<std::pair<const char*, double>> args = {});
+
+  // ---------------------------------------------------------------------------
+  // AddCounter
+  //
+  // Add a sample of a group of counters. Each arg is shown as a series
+  // ---------------------------------------------------------------------------
+  void AddCounter(const char* name,
+                  std::vector<std::pair<const char*, double>> args);
+
+  // ---------------------------------------------------------------------------
+  // Clear
+  //
+  // Remove all the events and restart the clock
+  // ---------------------------------------------------------------------------
+  void Clear();
+
+  // ---------------------------------------------------------------------------
+  // storeJSON
+  //
+  // Store the events in a file with the Chrome trace-event JSON format
+  // ---------------------------------------------------------------------------
+  bool storeJSON(const std::string& filePath) const;
+
+ private:
+  std::chrono::steady_clock::time_point origin;
+};
+
+// =============================================================================
+// TraceSpan
+//
+// Add a span to the trace with the lifetime of the object. Does nothing if
+// the trace is null or the build has no instrumentation.
+// =============================================================================
+class TraceSpan {
+ public:
+  TraceSpan(Trace* trace, const char* name)
+      : trace(Configuration::instrumentation ? trace : nullptr), name(name) {
+    if (this->trace) begin = this->trace->Now();
+  }
+
+  ~TraceSpan() {
+    if (trace) trace->AddSpan(name, begin, args);
+  }
+
+  // ---------------------------------------------------------------------------
+  // AddArg
+  //
+  // Add a value to show in the details of the span
+  // ---------------------------------------------------------------------------
+  void AddArg(const char* argName, double value) {
+    if (trace) args.push_back({argName, value});
+  }
+
+ private:
+  Trace* trace;
+  const char* name;
+  double begin;
+  std::vector<std::pair<const char*, double>> args;
+};
+
+}  // namespace sat
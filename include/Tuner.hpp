@@ -0,0 +1,142 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Project headers
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+namespace sat {
+
+// =============================================================================
+// TunerCandidate
+//
+// Values of the tuned options of the Solver and the results of SID with them
+// on the first instances of the tuner
+// =============================================================================
+struct TunerCandidate {
+  double fraction = 0.01;
+  double spEpsilon = 0.001;
+  double paramagneticState = 0.01;
+  double wsNoise = 0.57;
+  int wsMaxFlips = 100;
+
+  // Results: instances solved with SID, solved as SAT, stopped by their
+  // deadline, total seconds of SID and rounds of the successive halving the
+  // candidate took part in
+  unsigned instances = 0;
+  unsigned solved = 0;
+  unsigned timeouts = 0;
+  double seconds = 0.0;
+  unsigned rounds = 0;
+
+  // ---------------------------------------------------------------------------
+  // Read / Apply
+  //
+  // Copy the tuned options from or to a solver
+  // ---------------------------------------------------------------------------
+  void Read(const Solver& solver);
+  void Apply(Solver& solver) const;
+
+  // ---------------------------------------------------------------------------
+  // Before
+  //
+  // Ranking of the candidates: more rounds first, then more instances solved
+  // and then less time. Runs stopped by their deadline are not solved
+  // ---------------------------------------------------------------------------
+  bool Before(const TunerCandidate& other) const;
+};
+
+// =============================================================================
+// Tuner
+//
+// Search the tuned options of SID (fraction, SP epsilon, paramagnetic state,
+// walksat noise and flips) on a sample of instances with successive halving:
+// every round solves the instances of the round with all the remaining
+// candidates, keeps the best half of them and doubles the instances of the
+// next round, until one candidate is left. A candidate keeps the results of
+// the previous rounds, so only the new instances are solved.
+//
+// The candidates are the options of the base solver and configs random
+// samples (log-uniform, except the noise). The (candidate, instance) runs of
+// a round are solved by threads workers, each one with its own solver and its
+// own clones of the graphs. Every instance uses the same random stream with
+// all the candidates, so they are compared on the same runs of SID.
+//
+// The base candidate solves every instance before the other candidates, which
+// stop after timeFactor times its time on the same instance, so a bad
+// candidate can't take much longer than the base options.
+// =============================================================================
+class Tuner {
+ public:
+  int configs = 16;
+  int threads = 1;
+  GraphOrder graphOrder = ORDER_DIMACS;
+
+  // Simplify the instances with the Preprocessor before SID, as the
+  // experiment does. Instances found UNSAT are not solved by any candidate
+  bool preprocess = false;
+  bool variableElimination = false;
+
+  // Seconds of every run (0: no limit). The runs of the candidates other than
+  // the base one also stop after timeFactor times the seconds of the base
+  // candidate on the instance, and never before minSeconds
+  double timeout = 0;
+  double timeFactor = 5.0;
+  double minSeconds = 0.05;
+
+  // Ranges of the random candidates. The flips are multiplied by the
+  // variables of the instances
+  double minFraction = 0.0025, maxFraction = 0.04;
+  double minEpsilon = 0.0001, maxEpsilon = 0.01;
+  double minParamagnetic = 0.001, maxParamagnetic = 0.05;
+  double minNoise = 0.3, maxNoise = 0.7;
+  int minFlipsPerVariable = 10, maxFlipsPerVariable = 1000;
+
+  // All the candidates, best first after Run
+  std::vector<TunerCandidate> candidates;
+
+ public:
+  // ---------------------------------------------------------------------------
+  // Tuner constructor
+  //
+  // Instances are the paths of the DIMACS files, with N variables and
+  // clauses/variables ratio a. The seed is used to draw the candidates and
+  // by the solvers
+  // ---------------------------------------------------------------------------
+  Tuner(const std::vector<std::string>& instances, int N, double a,
+        unsigned long seed);
+
+  // ---------------------------------------------------------------------------
+  // Run
+  //
+  // Tune the options. configure sets the options that are not tuned in
+  // every solver (the tuned ones it sets are the base candidate). Returns the
+  // best candidate, or the base candidate if an instance can't be read
+  // ---------------------------------------------------------------------------
+  TunerCandidate Run(const std::function<void(Solver&)>& configure);
+
+ private:
+  std::vector<std::string> instances;
+  int N;
+  double alpha;
+  unsigned long seed;
+
+  // Graphs of the instances solved so far, cloned by the workers, and the
+  // instances refuted by the preprocessor
+  std::vector<std::unique_ptr<FactorGraph>> graphs;
+  std::vector<bool> refuted;
+
+  // Seconds of the base candidate by instance (-1 if not solved yet)
+  std::vector<double> baseSeconds;
+
+  bool load(unsigned instance);
+
+  bool solve(const std::vector<TunerCandidate*>& round, unsigned totalInstances,
+             const std::function<void(Solver&)>& configure);
+};
+
+}  // namespace sat
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cmath>
+
+// Project headers
+#include <Anderson.hpp>
+
+namespace sat {
+
+// =============================================================================
+// AndersonAcceleration
+// =============================================================================
+AndersonAcceleration::AndersonAcceleration(unsigned size, unsigned depth,
+                                           double lower, double upper)
+    : size(size),
+      depth(depth),
+      lower(lower),
+      upper(upper),
+      lastG(size),
+      lastF(size),
+      deltaG(depth, std::vector<double>(size)),
+      deltaF(depth, std::vector<double>(size)) {}
+
+void AndersonAcceleration::Restart() {
+  hasLast = false;
+  columns = 0;
+  first = 0;
+}
+
+bool AndersonAcceleration::Extrapolate(const std::vector<double>& x,
+                                       const std::vector<double>& g,
+                                       std::vector<double>& next) {
+  if (depth == 0) return false;
+
+  // ---------------------------------------------------------
+  // Add the differences with the last iterate to the history
+  // ---------------------------------------------------------
+  if (hasLast) {
+    unsigned column = (first + columns) % depth;
+    if (columns == depth)
+      first = (first + 1) % depth;
+    else
+      columns++;
+
+    for (unsigned i = 0; i < size; i++) {
+      double f = g[i] - x[i];
+      deltaG[column][i] = g[i] - lastG[i];
+      deltaF[column][i] = f - lastF[i];
+    }
+  }
+  for (unsigned i = 0; i < size; i++) {
+    lastG[i] = g[i];
+    lastF[i] = g[i] - x[i];
+  }
+  hasLast = true;
+  if (columns == 0) return false;
+
+  // -------------------------------------------------------------------
+  // Least squares: min |f - deltaF * gamma| with the normal equations
+  // (deltaF^T deltaF) gamma = deltaF^T f, regularized to stay solvable
+  // -------------------------------------------------------------------
+  unsigned m = columns;
+  std::vector<std::vector<double>> a(m, std::vector<double>(m + 1, 0.0));
+  for (unsigned r = 0; r < m; r++) {
+    const std::vector<double>& dr = deltaF[(first + r) % depth];
+    for (unsigned c = r; c < m; c++) {
+      const std::vector<double>& dc = deltaF[(first + c) % depth];
+      double dot = 0.0;
+      for (unsigned i = 0; i < size; i++) dot += dr[i] * dc[i];
+      a[r][c] = dot;
+      a[c][r] = dot;
+    }
+    double dot = 0.0;
+    for (unsigned i = 0; i < size; i++) dot += dr[i] * lastF[i];
+    a[r][m] = dot;
+  }
+
+  double trace = 0.0;
+  for (unsigned r = 0; r < m; r++) trace += a[r][r];
+  if (trace <= 0.0) return false;
+  for (unsigned r = 0; r < m; r++) a[r][r] += 1.0e-10 * trace;
+
+  // Gaussian elimination with partial pivoting
+  for (unsigned c = 0; c < m; c++) {
+    unsigned pivot = c;
+    for (unsigned r = c + 1; r < m; r++) {
+      if (std::abs(a[r][c]) > std::abs(a[pivot][c])) pivot = r;
+    }
+    if (std::abs(a[pivot][c]) < 1.0e-300) return false;
+    std::swap(a[c], a[pivot]);
+    for (unsigned r = c + 1; r < m; r++) {
+      double factor = a[r][c] / a[c][c];
+      for (unsigned k = c; k <= m; k++) a[r][k] -= factor * a[c][k];
+    }
+  }
+  std::vector<double> gamma(m);
+  for (int r = m - 1; r >= 0; r--) {
+    double value = a[r][m];
+    for (unsigned k = r + 1; k < m; k++) value -= a[r][k] * gamma[k];
+    gamma[r] = value / a[r][r];
+    if (!std::isfinite(gamma[r])) return false;
+  }
+
+  // ----------------------------------------
+  // next = g - deltaG * gamma, within bounds
+  // ----------------------------------------
+  next.resize(size);
+  for (unsigned i = 0; i < size; i++) {
+    double value = g[i];
+    for (unsigned r = 0; r < m; r++) {
+      value -= deltaG[(first + r) % depth][i] * gamma[r];
+    }
+    next[i] = std::min(upper, std::max(lower, value));
+  }
+  return true;
+}
+
+}  // namespace sat
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -11,7 +13,21 @@ namespace sat {
 // =============================================================================
 // Variable class
 // =============================================================================
-Variable::Variable(const unsigned id) : id(id), assigned(false) {}
+Variable::Variable(const unsigned id) : id(id) { Reset(); }
+
+void Variable::Reset() {
+  assigned = false;
+  value = false;
+  p = 1.0;
+  m = 1.0;
+  pzero = 0;
+  mzero = 0;
+  maxBias = 0.0;
+  Hp = 0.0;
+  Hz = 0.0;
+  Hm = 0.0;
+  evalValue = 0.0;
+}
 
 std::vector<Edge*> Variable::GetEnabledEdges() {
   std::vector<Edge*> enabledNeigbours;
@@ -35,7 +51,12 @@ std::ostream& operator<<(std::ostream& os, const Variable* var) {
 // =============================================================================
 // Clause class
 // =============================================================================
-Clause::Clause(const unsigned id) : id(id), enabled(true) {}
+Clause::Clause(const unsigned id) : id(id) { Reset(); }
+
+void Clause::Reset() {
+  enabled = true;
+  trueLiterals = 0;
+}
 
 std::vector<Edge*> Clause::GetEnabledEdges() const {
   std::vector<Edge*> enabledNeigbours;
@@ -83,7 +104,14 @@ std::ostream& operator<<(std::ostream& os, const Clause* c) {
 // Edge class
 // =============================================================================
 Edge::Edge(bool type, Clause* clause, Variable* variable)
-    : type(type), enabled(true), clause(clause), variable(variable) {}
+    : type(type), clause(clause), variable(variable) {
+  Reset();
+}
+
+void Edge::Reset() {
+  enabled = true;
+  survey = 0.0;
+}
 
 void Edge::Dissable() { enabled = false; }
 
@@ -92,7 +120,7 @@ std::ostream& operator<<(std::ostream& os, const Edge* e) {
   os << (e->type ? " X" : "¬X") << e->variable->id;
   os << " - " << (e->enabled ? "ENABLED " : "DISABLED");
   // os << " (" << std::fixed << std::setprecision(10) << e->survey << ")";
-  os << " (" << e->survey << ")";
+  os << " (" << (double)e->survey << ")";
   return os;
 }
 
@@ -112,74 +140,275 @@ const std::vector<std::string> FactorGraph::SplitString(const std::string& s) {
   return tokens;
 }
 
-FactorGraph::FactorGraph(std::ifstream& file) {
-  // Process each line of the dimacs file
+FactorGraph::FactorGraph(std::istream& file, GraphOrder order) {
+  // Read the literals of every clause, finishing each clause with a 0
   bool configured = false;
-  int currentClauseIndex = 0;
+  unsigned totalVariables = 0;
+  unsigned totalClauses = 0;
+  unsigned currentClauseIndex = 0;
+  std::vector<int> literals;
   std::string line;
   while (getline(file, line)) {
     // Split the lines into tokens
     const std::vector<std::string> tokens = SplitString(line);
 
+    // Ignore empty lines
+    if (tokens.empty()) continue;
+
     // If first token is a 'c' ignore the line because is a comment
     if (tokens[0] == "c") continue;
 
     // If first token is a 'p' and second is 'cnf',
     // the line contains the number of variables (3rd) and clauses (4th)
     else if (tokens[0] == "p" && tokens[1] == "cnf") {
-      unsigned int totalVariables = stoi(tokens[2]);
-      unsigned int totalClauses = stoi(tokens[3]);
-
-      // Create variables
-      for (unsigned i = 0; i < totalVariables; i++) {
-        Variable* variable = new Variable(i + 1);
-        variables.push_back(variable);
-      }
-
-      // Create clauses
-      for (unsigned i = 0; i < totalClauses; i++) {
-        Clause* clause = new Clause(i + 1);
-        clauses.push_back(clause);
-      }
-
+      totalVariables = stoi(tokens[2]);
+      totalClauses = stoi(tokens[3]);
+      literals.reserve(totalClauses * 4);
       configured = true;
     }
 
     // Every other line should be a clause containing variables
     else {
-      if (configured) {
+      if (configured && currentClauseIndex < totalClauses) {
         for (const std::string& token : tokens) {
           // "0" means end of the clause
-          if (token != "0") {
-            const int variableValue = stoi(token);
-            // variables start from 1 and indices from 0
-            const int variableIndex = std::abs(variableValue) - 1;
-
-            // Create an edge
-            bool edgeType = variableValue > 0;
-            Clause* clause = clauses[currentClauseIndex];
-            Variable* variable = variables[variableIndex];
-
-            Edge* edge = new Edge(edgeType, clause, variable);
-            edges.push_back(edge);
-
-            // Connect clauses and variables with the edge
-            clause->allNeighbourEdges.push_back(edge);
-            variable->allNeighbourEdges.push_back(edge);
-          }
+          if (token != "0") literals.push_back(stoi(token));
         }
+        literals.push_back(0);
 
         // Next clause
         currentClauseIndex += 1;
       }
     }
   }
+
+  // Clauses declared in the header but missing in the file are empty
+  for (; currentClauseIndex < totalClauses; currentClauseIndex++) {
+    literals.push_back(0);
+  }
+
+  std::vector<unsigned> variableIds(totalVariables);
+  for (unsigned v = 0; v < totalVariables; v++) variableIds[v] = v + 1;
+  Build(variableIds, literals, order);
+}
+
+FactorGraph::FactorGraph(const std::vector<unsigned>& variableIds,
+                         const std::vector<int>& literals, GraphOrder order) {
+  Build(variableIds, literals, order);
+}
+
+// -----------------------------------------------------------------------------
+// Reverse Cuthill-McKee order of the variables, where two variables are
+// neighbours if they appear in the same clause. Every connected component is
+// traversed in BFS from a variable of minimum degree, visiting the neighbours
+// by increasing degree, and the whole order is reversed at the end.
+// The number of occurrences of a variable is used as its degree
+// -----------------------------------------------------------------------------
+static std::vector<unsigned> reverseCuthillMcKee(
+    unsigned totalVariables, const std::vector<int>& literals,
+    const std::vector<unsigned>& clauseBegin,
+    const std::vector<unsigned>& occurrenceBegin,
+    const std::vector<unsigned>& occurrences) {
+  auto degree = [&](unsigned v) {
+    return occurrenceBegin[v + 1] - occurrenceBegin[v];
+  };
+  auto byDegree = [&](unsigned a, unsigned b) { return degree(a) < degree(b); };
+
+  std::vector<unsigned> starts(totalVariables);
+  for (unsigned v = 0; v < totalVariables; v++) starts[v] = v;
+  std::stable_sort(starts.begin(), starts.end(), byDegree);
+
+  std::vector<unsigned> order;
+  order.reserve(totalVariables);
+  std::vector<bool> visited(totalVariables, false);
+  std::vector<unsigned> neighbours;
+  for (unsigned start : starts) {
+    if (visited[start]) continue;
+    visited[start] = true;
+    order.push_back(start);
+
+    // The order vector is the BFS queue
+    for (unsigned head = order.size() - 1; head < order.size(); head++) {
+      unsigned v = order[head];
+      neighbours.clear();
+      for (unsigned o = occurrenceBegin[v]; o < occurrenceBegin[v + 1]; o++) {
+        unsigned c = occurrences[o];
+        for (unsigned l = clauseBegin[c]; l < clauseBegin[c + 1] - 1; l++) {
+          unsigned u = std::abs(literals[l]) - 1;
+          if (!visited[u]) {
+            visited[u] = true;
+            neighbours.push_back(u);
+          }
+        }
+      }
+      std::stable_sort(neighbours.begin(), neighbours.end(), byDegree);
+      order.insert(order.end(), neighbours.begin(), neighbours.end());
+    }
+  }
+
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+void FactorGraph::Build(const std::vector<unsigned>& variableIds,
+                        const std::vector<int>& literals, GraphOrder order) {
+  unsigned totalVariables = variableIds.size();
+
+  // Index of the first literal of every clause, plus the end of the last one
+  std::vector<unsigned> clauseBegin = {0};
+  for (unsigned l = 0; l < literals.size(); l++) {
+    if (literals[l] == 0) clauseBegin.push_back(l + 1);
+  }
+  unsigned totalClauses = clauseBegin.size() - 1;
+  unsigned totalEdges = literals.size() - totalClauses;
+
+  // Clauses where every variable appears (compressed rows)
+  std::vector<unsigned> occurrenceBegin(totalVariables + 1, 0);
+  for (int literal : literals) {
+    if (literal != 0) occurrenceBegin[std::abs(literal)]++;
+  }
+  for (unsigned v = 0; v < totalVariables; v++) {
+    occurrenceBegin[v + 1] += occurrenceBegin[v];
+  }
+  std::vector<unsigned> occurrences(totalEdges);
+  std::vector<unsigned> filled(occurrenceBegin.begin(), occurrenceBegin.end());
+  for (unsigned c = 0; c < totalClauses; c++) {
+    for (unsigned l = clauseBegin[c]; l < clauseBegin[c + 1] - 1; l++) {
+      occurrences[filled[std::abs(literals[l]) - 1]++] = c;
+    }
+  }
+
+  // Position of the variables and clauses in the graph
+  std::vector<unsigned> variableOrder(totalVariables);
+  std::vector<unsigned> clauseOrder(totalClauses);
+  for (unsigned v = 0; v < totalVariables; v++) variableOrder[v] = v;
+  for (unsigned c = 0; c < totalClauses; c++) clauseOrder[c] = c;
+  if (order == ORDER_RCM) {
+    variableOrder = reverseCuthillMcKee(totalVariables, literals, clauseBegin,
+                                        occurrenceBegin, occurrences);
+
+    // Clauses follow the first of their variables in the new order
+    std::vector<unsigned> rank(totalVariables);
+    for (unsigned v = 0; v < totalVariables; v++) rank[variableOrder[v]] = v;
+    std::vector<unsigned> clauseRank(totalClauses, totalVariables);
+    for (unsigned c = 0; c < totalClauses; c++) {
+      for (unsigned l = clauseBegin[c]; l < clauseBegin[c + 1] - 1; l++) {
+        unsigned r = rank[std::abs(literals[l]) - 1];
+        if (r < clauseRank[c]) clauseRank[c] = r;
+      }
+    }
+    std::stable_sort(
+        clauseOrder.begin(), clauseOrder.end(),
+        [&](unsigned a, unsigned b) { return clauseRank[a] < clauseRank[b]; });
+  }
+
+  // Neighbour lists: the edges of every clause (all the edges in the pool
+  // order) followed by the edges of every variable
+  std::vector<unsigned>* lists = new std::vector<unsigned>(2 * totalEdges);
+  adjacency.reset(lists);
+  const unsigned* clauseLists = lists->data();
+  const unsigned* variableLists = lists->data() + totalEdges;
+
+  // Create variables. Their lists are filled with the edges
+  std::vector<Variable*> variableByIndex(totalVariables);
+  std::vector<unsigned> variableFilled(totalVariables);
+  variablePool.reserve(totalVariables);
+  variables.reserve(totalVariables);
+  edgePool.reserve(totalEdges);
+  unsigned position = 0;
+  for (unsigned v : variableOrder) {
+    variablePool.emplace_back(variableIds[v]);
+    Variable* variable = &variablePool.back();
+    unsigned occurrences = occurrenceBegin[v + 1] - occurrenceBegin[v];
+    variable->allNeighbourEdges =
+        EdgeList(variableLists + position,
+                 variableLists + position + occurrences, edgePool.data());
+    variableFilled[v] = totalEdges + position;
+    position += occurrences;
+    variableByIndex[v] = variable;
+    variables.push_back(variable);
+  }
+
+  // Create clauses and their edges
+  clausePool.reserve(totalClauses);
+  clauses.reserve(totalClauses);
+  edges.reserve(totalEdges);
+  for (unsigned c : clauseOrder) {
+    clausePool.emplace_back(c + 1);
+    Clause* clause = &clausePool.back();
+    unsigned first = edgePool.size();
+    clause->allNeighbourEdges =
+        EdgeList(clauseLists + first,
+                 clauseLists + first + clauseBegin[c + 1] - clauseBegin[c] - 1,
+                 edgePool.data());
+    clauses.push_back(clause);
+
+    for (unsigned l = clauseBegin[c]; l < clauseBegin[c + 1] - 1; l++) {
+      // Create an edge
+      // variables start from 1 and indices from 0
+      bool edgeType = literals[l] > 0;
+      unsigned v = std::abs(literals[l]) - 1;
+      edgePool.emplace_back(edgeType, clause, variableByIndex[v]);
+      edges.push_back(&edgePool.back());
+
+      // Connect clauses and variables with the edge
+      (*lists)[edgePool.size() - 1] = edgePool.size() - 1;
+      (*lists)[variableFilled[v]++] = edgePool.size() - 1;
+    }
+  }
+}
+
+FactorGraph* FactorGraph::Clone() const {
+  FactorGraph* clone = new FactorGraph();
+  clone->adjacency = adjacency;
+  // Copy constructed, nodes are not assignable
+  clone->variablePool = std::vector<Variable>(variablePool);
+  clone->clausePool = std::vector<Clause>(clausePool);
+  clone->edgePool = std::vector<Edge>(edgePool);
+
+  // The copied nodes still point to the nodes of this graph, at the same
+  // positions of the pools
+  Variable* variableBase = clone->variablePool.data();
+  Clause* clauseBase = clone->clausePool.data();
+  Edge* edgeBase = clone->edgePool.data();
+  clone->variables.reserve(variables.size());
+  for (Variable& variable : clone->variablePool) {
+    variable.allNeighbourEdges.pool = edgeBase;
+    clone->variables.push_back(&variable);
+  }
+  clone->clauses.reserve(clauses.size());
+  for (Clause& clause : clone->clausePool) {
+    clause.allNeighbourEdges.pool = edgeBase;
+    clone->clauses.push_back(&clause);
+  }
+  clone->edges.reserve(edges.size());
+  for (Edge& edge : clone->edgePool) {
+    edge.clause = clauseBase + (edge.clause - clausePool.data());
+    edge.variable = variableBase + (edge.variable - variablePool.data());
+    clone->edges.push_back(&edge);
+  }
+  return clone;
 }
 
-FactorGraph::~FactorGraph() {
-  for (Clause* clause : clauses) delete clause;
-  for (Variable* variable : variables) delete variable;
-  for (Edge* edge : edges) delete edge;
+const char* FactorGraph::GraphOrderName(GraphOrder order) {
+  switch (order) {
+    case ORDER_DIMACS:
+      return "dimacs";
+    case ORDER_RCM:
+      return "rcm";
+    default:
+      return "unknown";
+  }
+}
+
+bool FactorGraph::ParseGraphOrder(const std::string& name, GraphOrder& order) {
+  for (int i = 0; i < TOTAL_GRAPH_ORDERS; i++) {
+    if (name == GraphOrderName((GraphOrder)i)) {
+      order = (GraphOrder)i;
+      return true;
+    }
+  }
+  return false;
 }
 
 std::vector<Variable*> FactorGraph::GetUnassignedVariables() {
@@ -214,11 +443,78 @@ bool FactorGraph::IsSAT() const {
   return true;
 }
 
+void FactorGraph::Reset() {
+  for (Variable* variable : variables) variable->Reset();
+  for (Clause* clause : clauses) clause->Reset();
+  for (Edge* edge : edges) edge->Reset();
+}
+
+// Heap bytes of a vector of pointers with the given capacity
+static size_t vectorHeapSize(size_t capacity) {
+  return HeapSize(capacity * sizeof(void*));
+}
+
+MemoryUsage FactorGraph::GetMemoryUsage() const {
+  MemoryUsage usage;
+
+  usage.variables = vectorHeapSize(variables.capacity()) +
+                    HeapSize(variablePool.capacity() * sizeof(Variable));
+  usage.clauses = vectorHeapSize(clauses.capacity()) +
+                  HeapSize(clausePool.capacity() * sizeof(Clause));
+  if (adjacency)
+    usage.adjacency = HeapSize(adjacency->capacity() * sizeof(unsigned));
+
+  usage.edges = vectorHeapSize(edges.capacity()) +
+                HeapSize(edgePool.capacity() * sizeof(Edge));
+
+  return usage;
+}
+
+MemoryUsage FactorGraph::EstimateMemoryUsage(unsigned totalVariables,
+                                             unsigned totalClauses,
+                                             unsigned k) {
+  MemoryUsage usage;
+  size_t totalEdges = (size_t)totalClauses * k;
+
+  // All the vectors are reserved with their exact size
+  usage.variables = vectorHeapSize(totalVariables) +
+                    HeapSize(totalVariables * sizeof(Variable));
+  usage.clauses = vectorHeapSize(totalClauses) +
+                  HeapSize(totalClauses * sizeof(Clause));
+  usage.edges = vectorHeapSize(totalEdges) +
+                HeapSize(totalEdges * sizeof(Edge));
+
+  // Every edge is in the list of its clause and in the one of its variable
+  usage.adjacency = HeapSize(2 * totalEdges * sizeof(unsigned));
+
+  return usage;
+}
+
+MemoryUsage FactorGraph::EstimateMemoryUsage(std::istream& file, unsigned k) {
+  std::string line;
+  while (getline(file, line)) {
+    std::istringstream stream(line);
+    std::string token, format;
+    stream >> token;
+    if (token == "p" && stream >> format && format == "cnf") {
+      unsigned totalVariables = 0, totalClauses = 0;
+      stream >> totalVariables >> totalClauses;
+      return EstimateMemoryUsage(totalVariables, totalClauses, k);
+    }
+  }
+  return MemoryUsage();
+}
+
 bool FactorGraph::storeVariableValues(const std::string& filePath) {
+  unsigned maxId = 0;
+  for (Variable* var : variables) maxId = std::max(maxId, var->id);
+  std::vector<bool> values(maxId, false);
+  for (Variable* var : variables) values[var->id - 1] = var->value;
+
   std::ofstream resultFile;
   resultFile.open(filePath);
-  for (Variable* var : variables) {
-    resultFile << var->value << "\n";
+  for (bool value : values) {
+    resultFile << value << "\n";
   }
   resultFile.close();
   return true;
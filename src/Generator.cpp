@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <cstdlib>
+
+// Project headers
+#include <Generator.hpp>
+
+namespace sat {
+
+// =============================================================================
+// Generator
+// =============================================================================
+Generator::Generator(unsigned seed) : randomGenerator(seed) {}
+
+void Generator::RandomKSAT(std::ostream& os, int N, int M, int k) {
+  writeFormula(os, N, M, k, nullptr);
+}
+
+void Generator::PlantedKSAT(std::ostream& os, int N, int M, int k,
+                            std::vector<bool>& solution) {
+  std::uniform_int_distribution<> randomBool(0, 1);
+  solution.resize(N);
+  for (int i = 0; i < N; i++) solution[i] = randomBool(randomGenerator);
+
+  writeFormula(os, N, M, k, &solution);
+}
+
+void Generator::writeFormula(std::ostream& os, int N, int M, int k,
+                             const std::vector<bool>* solution) {
+  std::uniform_int_distribution<> randomVariable(1, N);
+  std::uniform_int_distribution<> randomBool(0, 1);
+  std::uniform_int_distribution<> randomLiteral(0, k - 1);
+
+  os << "p cnf " << N << " " << M << "\n";
+
+  std::vector<int> variables(k);
+  std::vector<int> literals(k);
+  for (int c = 0; c < M; c++) {
+    // Draw k different variables
+    for (int i = 0; i < k; i++) {
+      do {
+        variables[i] = randomVariable(randomGenerator);
+      } while (std::find(variables.begin(), variables.begin() + i,
+                         variables[i]) != variables.begin() + i);
+      literals[i] = randomBool(randomGenerator) ? variables[i] : -variables[i];
+    }
+
+    // Force the clause to be satisfied by the planted solution flipping one
+    // of its literals
+    if (solution) {
+      bool sat = false;
+      for (int literal : literals) {
+        if ((*solution)[std::abs(literal) - 1] == (literal > 0)) sat = true;
+      }
+      if (!sat) {
+        int i = randomLiteral(randomGenerator);
+        literals[i] = -literals[i];
+      }
+    }
+
+    for (int literal : literals) os << literal << " ";
+    os << "0\n";
+  }
+}
+
+}  // namespace sat
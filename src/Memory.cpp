@@ -0,0 +1,85 @@
+#include <sys/resource.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// Project headers
+#include <Memory.hpp>
+
+namespace sat {
+
+// =============================================================================
+// MemoryUsage
+// =============================================================================
+size_t MemoryUsage::Total() const {
+  return variables + clauses + edges + adjacency + scratch;
+}
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& other) {
+  variables += other.variables;
+  clauses += other.clauses;
+  edges += other.edges;
+  adjacency += other.adjacency;
+  scratch += other.scratch;
+  return *this;
+}
+
+std::ostream& operator<<(std::ostream& os, const MemoryUsage& usage) {
+  const double MB = 1024.0 * 1024.0;
+  os << " Variables: " << usage.variables / MB << "MB" << std::endl;
+  os << " Clauses: " << usage.clauses / MB << "MB" << std::endl;
+  os << " Edges: " << usage.edges / MB << "MB" << std::endl;
+  os << " Adjacency: " << usage.adjacency / MB << "MB" << std::endl;
+  os << " Solver scratch: " << usage.scratch / MB << "MB" << std::endl;
+  os << " Total: " << usage.Total() / MB << "MB" << std::endl;
+  return os;
+}
+
+size_t HeapSize(size_t size) {
+  if (size == 0) return 0;
+  size_t chunk = (size + 8 + 15) & ~(size_t)15;
+  return chunk < 32 ? 32 : chunk;
+}
+
+// =============================================================================
+// Process memory
+// =============================================================================
+
+// Read a field (in KB) from /proc/self/status
+static long readStatusField(const std::string& field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, field.size(), field) == 0) {
+      std::istringstream stream(line.substr(field.size() + 1));
+      long value = 0;
+      stream >> value;
+      return value;
+    }
+  }
+  return 0;
+}
+
+long GetPeakRSS() {
+  long peak = readStatusField("VmHWM");
+  if (peak > 0) return peak;
+
+  // Fallback to the high water mark of the whole process
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+  return usage.ru_maxrss;
+}
+
+long GetCurrentRSS() { return readStatusField("VmRSS"); }
+
+bool ResetPeakRSS() {
+  // Writing 5 to clear_refs resets the peak RSS of the process (Linux >= 4.0)
+  std::ofstream clearRefs("/proc/self/clear_refs");
+  if (!clearRefs.is_open()) return false;
+  clearRefs << "5";
+  clearRefs.close();
+  return !clearRefs.fail();
+}
+
+}  // namespace sat
@@ -0,0 +1,84 @@
+#include <fstream>
+
+// Project headers
+#include <Metrics.hpp>
+
+namespace sat {
+
+// =============================================================================
+// Metrics
+// =============================================================================
+Metrics::Metrics() { Reset(); }
+
+void Metrics::Reset() {
+  for (int i = 0; i < TOTAL_PHASES; i++) {
+    calls[i] = 0;
+    nanoseconds[i] = 0;
+    depth[i] = 0;
+  }
+}
+
+Metrics& Metrics::operator+=(const Metrics& other) {
+  for (int i = 0; i < TOTAL_PHASES; i++) {
+    calls[i] += other.calls[i];
+    nanoseconds[i] += other.nanoseconds[i];
+  }
+  return *this;
+}
+
+const char* Metrics::PhaseName(Phase phase) {
+  switch (phase) {
+    case PHASE_SP_SWEEP:
+      return "sp_sweep";
+    case PHASE_SUBPRODUCTS:
+      return "subproducts";
+    case PHASE_BIAS:
+      return "bias";
+    case PHASE_FIX:
+      return "fix";
+    case PHASE_UP:
+      return "unit_propagation";
+    case PHASE_IS_SAT:
+      return "is_sat";
+    case PHASE_WALKSAT_FLIP:
+      return "walksat_flip";
+    default:
+      return "unknown";
+  }
+}
+
+bool Metrics::storeCSV(const std::string& filePath) const {
+  std::ofstream file(filePath);
+  if (!file.is_open()) return false;
+
+  file << "phase,calls,ns\n";
+  for (int i = 0; i < TOTAL_PHASES; i++) {
+    file << PhaseName((Phase)i) << "," << calls[i] << "," << nanoseconds[i]
+         << "\n";
+  }
+  return true;
+}
+
+bool Metrics::storeJSON(const std::string& filePath) const {
+  std::ofstream file(filePath);
+  if (!file.is_open()) return false;
+
+  file << "{";
+  for (int i = 0; i < TOTAL_PHASES; i++) {
+    if (i > 0) file << ",";
+    file << "\n  \"" << PhaseName((Phase)i) << "\": {\"calls\": " << calls[i]
+         << ", \"ns\": " << nanoseconds[i] << "}";
+  }
+  file << "\n}\n";
+  return true;
+}
+
+std::ostream& operator<<(std::ostream& os, const Metrics& metrics) {
+  for (int i = 0; i < TOTAL_PHASES; i++) {
+    os << " " << Metrics::PhaseName((Phase)i) << ": " << metrics.calls[i]
+       << " calls - " << metrics.nanoseconds[i] / 1.0e6 << "ms" << std::endl;
+  }
+  return os;
+}
+
+}  // namespace sat
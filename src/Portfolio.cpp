@@ -0,0 +1,133 @@
+#include <Portfolio.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace sat {
+
+// =============================================================================
+// Portfolio
+// =============================================================================
+void Portfolio::Add(double fraction, DecimationSchedule schedule,
+                    SweepOrder sweepOrder) {
+  PortfolioMember member;
+  member.fraction = fraction;
+  member.schedule = schedule;
+  member.sweepOrder = sweepOrder;
+  members.push_back(member);
+}
+
+AlgorithmResult Portfolio::Solve(
+    FactorGraph* graph, unsigned long seed, unsigned long stream,
+    const std::function<void(Solver&)>& configure) {
+  auto begin = std::chrono::steady_clock::now();
+  for (PortfolioMember& member : members) {
+    member.started = false;
+    member.result = INDETERMINATE;
+    member.seconds = 0.0;
+    member.spIterations = 0;
+    member.sidIterations = 0;
+  }
+  winner = -1;
+  expired = false;
+  seconds = 0.0;
+  if (members.empty()) return INDETERMINATE;
+
+  auto deadline = std::chrono::steady_clock::time_point::max();
+  if (budget > 0)
+    deadline = begin + std::chrono::duration_cast<
+                           std::chrono::steady_clock::duration>(
+                           std::chrono::duration<double>(budget));
+
+  int N = graph->variables.size();
+  double alpha = N ? (double)graph->clauses.size() / N : 0.0;
+
+  // ------------------------------------------------------------------
+  // Workers take the next member until all of them are done or the
+  // portfolio is stopped. The first SAT wins, stops the others and
+  // keeps its model. The graph is only read until all of them finish
+  // ------------------------------------------------------------------
+  std::vector<bool> model;
+  std::atomic<bool> stop(false);
+  std::atomic<int> firstSAT(-1);
+  std::atomic<unsigned> nextMember(0);
+  std::mutex mutex;
+  std::condition_variable finished;
+  unsigned totalThreads =
+      std::max(1, std::min(threads, (int)members.size()));
+  unsigned runningThreads = totalThreads;
+
+  auto worker = [&]() {
+    for (unsigned m = nextMember++; m < members.size() && !stop;
+         m = nextMember++) {
+      PortfolioMember& member = members[m];
+      auto memberBegin = std::chrono::steady_clock::now();
+      member.started = true;
+
+      std::unique_ptr<FactorGraph> copy(graph->Clone());
+      Solver solver(N, alpha, 1);
+      configure(solver);
+      solver.schedule = member.schedule;
+      solver.sweepOrder = member.sweepOrder;
+      solver.threads = 1;
+      solver.cancel = &stop;
+      solver.deadline = deadline;
+      solver.setSeed(seed + m, stream);
+      member.result = solver.SID(copy.get(), member.fraction);
+      member.spIterations = solver.totalSPIterations;
+      member.sidIterations = solver.totalSIDIterations;
+
+      int none = -1;
+      if (member.result == SAT && firstSAT.compare_exchange_strong(none, m)) {
+        stop = true;
+        for (Variable* var : copy->variables) model.push_back(var->value);
+      }
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - memberBegin;
+      member.seconds = elapsed.count();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    runningThreads--;
+    finished.notify_all();
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < totalThreads; t++) pool.emplace_back(worker);
+
+  // The calling thread only waits for the workers or the end of the budget
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto done = [&]() { return runningThreads == 0; };
+    if (budget > 0) {
+      expired = !finished.wait_until(lock, deadline, done);
+    } else {
+      finished.wait(lock, done);
+    }
+  }
+  stop = true;
+  for (std::thread& t : pool) t.join();
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+  seconds = elapsed.count();
+  winner = std::max(firstSAT.load(), 0);
+  // The members also stop themselves at the end of the budget. A solution
+  // found just when the budget was over still counts
+  for (const PortfolioMember& member : members)
+    expired = expired || member.result == TIMEOUT;
+  if (firstSAT >= 0) expired = false;
+  // Variable i of the clones is the variable i of the graph
+  for (unsigned i = 0; i < model.size(); i++)
+    graph->variables[i]->AssignValue(model[i]);
+  AlgorithmResult result = members[winner].result;
+  if (result == SAT && !graph->IsSAT()) result = INDETERMINATE;
+  if (expired) result = TIMEOUT;
+  return result;
+}
+
+}  // namespace sat
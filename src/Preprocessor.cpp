@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+// Project headers
+#include <Preprocessor.hpp>
+
+namespace sat {
+
+// =============================================================================
+// Preprocessor
+// =============================================================================
+Preprocessor::Preprocessor(const FactorGraph& graph)
+    : totalVariables(graph.variables.size()),
+      originalClauses(graph.clauses.size()) {
+  // Variables can be stored in any order, but their ids are 1..N
+  for (Variable* var : graph.variables) {
+    totalVariables = std::max(totalVariables, var->id);
+  }
+
+  // Clauses are stored in the order of their ids
+  clauses.resize(graph.clauses.size());
+  for (Clause* clause : graph.clauses) {
+    std::vector<int>& literals = clauses[clause->id - 1];
+    for (Edge* edge : clause->allNeighbourEdges) {
+      int id = edge->variable->id;
+      literals.push_back(edge->type ? id : -id);
+    }
+  }
+  removed.assign(clauses.size(), false);
+  values.assign(totalVariables, 0);
+  eliminated.assign(totalVariables, false);
+}
+
+bool Preprocessor::Run() {
+  duplicateLiterals = 0;
+  tautologies = 0;
+  unitLiterals = 0;
+  pureLiterals = 0;
+  eliminatedVariables = 0;
+  duplicateClauses = 0;
+
+  occurrences.assign(2 * totalVariables, {});
+  literalCount.assign(2 * totalVariables, 0);
+  pending.clear();
+
+  normalizeClauses();
+
+  // Occurrence lists of the remaining clauses. Empty clauses make the
+  // formula UNSAT and unit clauses are the first literals to propagate
+  for (unsigned c = 0; c < clauses.size(); c++) {
+    if (removed[c]) continue;
+    if (clauses[c].empty()) return false;
+    if (clauses[c].size() == 1) pending.push_back({clauses[c][0], false});
+    for (int literal : clauses[c]) {
+      occurrences[literalIndex(literal)].push_back(c);
+      literalCount[literalIndex(literal)]++;
+    }
+  }
+
+  // Variables that only appear with one sign
+  for (int id = 1; id <= (int)totalVariables; id++) {
+    unsigned positive = literalCount[literalIndex(id)];
+    unsigned negative = literalCount[literalIndex(-id)];
+    if (positive > 0 && negative == 0) pending.push_back({id, true});
+    if (negative > 0 && positive == 0) pending.push_back({-id, true});
+  }
+
+  if (!propagate()) return false;
+  if (variableElimination && !eliminateVariables()) return false;
+
+  // Propagation and elimination keep the order of the literals, so they are
+  // still sorted and equal clauses have equal vectors
+  removeDuplicateClauses();
+  return true;
+}
+
+void Preprocessor::normalizeClauses() {
+  for (unsigned c = 0; c < clauses.size(); c++) {
+    if (removed[c]) continue;
+    std::vector<int>& literals = clauses[c];
+    std::sort(literals.begin(), literals.end(), literalLess);
+
+    // Remove repeated literals
+    std::vector<int>::iterator last =
+        std::unique(literals.begin(), literals.end());
+    duplicateLiterals += literals.end() - last;
+    literals.erase(last, literals.end());
+
+    // A variable with both signs makes the clause always true
+    for (unsigned l = 1; l < literals.size(); l++) {
+      if (literals[l] == -literals[l - 1]) {
+        removed[c] = true;
+        tautologies++;
+        break;
+      }
+    }
+  }
+}
+
+bool Preprocessor::propagate() {
+  while (!pending.empty()) {
+    std::pair<int, bool> next = pending.back();
+    pending.pop_back();
+    int literal = next.first;
+    signed char value = literal > 0 ? 1 : -1;
+    signed char current = values[std::abs(literal) - 1];
+
+    // Already fixed: a unit literal with the opposite value is a conflict
+    if (current == value) continue;
+    if (current != 0) return false;
+
+    // A pure literal may have lost all its clauses in the meantime, and
+    // then the variable doesn't need a value
+    if (next.second && literalCount[literalIndex(literal)] == 0) continue;
+
+    if (next.second)
+      pureLiterals++;
+    else
+      unitLiterals++;
+    if (!fixLiteral(literal)) return false;
+  }
+  return true;
+}
+
+bool Preprocessor::fixLiteral(int literal) {
+  values[std::abs(literal) - 1] = literal > 0 ? 1 : -1;
+
+  // Clauses with the literal are satisfied
+  for (unsigned c : occurrences[literalIndex(literal)]) {
+    if (!removed[c]) removeClause(c);
+  }
+  occurrences[literalIndex(literal)].clear();
+
+  // Clauses with the opposite literal lose it
+  for (unsigned c : occurrences[literalIndex(-literal)]) {
+    if (removed[c]) continue;
+    std::vector<int>& literals = clauses[c];
+    literals.erase(std::find(literals.begin(), literals.end(), -literal));
+    literalCount[literalIndex(-literal)]--;
+
+    if (literals.empty()) return false;
+    if (literals.size() == 1) pending.push_back({literals[0], false});
+  }
+  occurrences[literalIndex(-literal)].clear();
+
+  return true;
+}
+
+void Preprocessor::removeClause(unsigned c) {
+  removed[c] = true;
+  for (int literal : clauses[c]) {
+    // The last occurrence of a literal of a free variable makes the
+    // opposite literal pure
+    unsigned v = std::abs(literal) - 1;
+    if (--literalCount[literalIndex(literal)] == 0 && values[v] == 0 &&
+        !eliminated[v] && literalCount[literalIndex(-literal)] > 0) {
+      pending.push_back({-literal, true});
+    }
+  }
+}
+
+bool Preprocessor::addClause(const std::vector<int>& literals) {
+  if (literals.empty()) return false;
+
+  unsigned c = clauses.size();
+  clauses.push_back(literals);
+  removed.push_back(false);
+  for (int literal : literals) {
+    occurrences[literalIndex(literal)].push_back(c);
+    literalCount[literalIndex(literal)]++;
+  }
+  if (literals.size() == 1) pending.push_back({literals[0], false});
+  return true;
+}
+
+std::vector<unsigned> Preprocessor::activeOccurrences(int literal) const {
+  std::vector<unsigned> active;
+  for (unsigned c : occurrences[literalIndex(literal)]) {
+    if (removed[c]) continue;
+    const std::vector<int>& literals = clauses[c];
+    if (std::binary_search(literals.begin(), literals.end(), literal,
+                           literalLess))
+      active.push_back(c);
+  }
+  return active;
+}
+
+bool Preprocessor::resolve(const std::vector<int>& positive,
+                           const std::vector<int>& negative, unsigned id,
+                           std::vector<int>& resolvent) const {
+  // Merge of two sorted clauses without the resolved variable
+  resolvent.clear();
+  unsigned p = 0, n = 0;
+  while (p < positive.size() || n < negative.size()) {
+    int literal;
+    if (n == negative.size() ||
+        (p < positive.size() && literalLess(positive[p], negative[n])))
+      literal = positive[p++];
+    else
+      literal = negative[n++];
+
+    if ((unsigned)std::abs(literal) == id) continue;
+    if (!resolvent.empty() && resolvent.back() == literal) continue;
+    if (!resolvent.empty() && resolvent.back() == -literal) return false;
+    resolvent.push_back(literal);
+  }
+  return true;
+}
+
+bool Preprocessor::boundedResolvents(
+    unsigned id, std::vector<std::vector<int>>& resolvents) const {
+  std::vector<unsigned> positive = activeOccurrences(id);
+  std::vector<unsigned> negative = activeOccurrences(-id);
+  unsigned totalClauses = positive.size() + negative.size();
+  if (positive.empty() || negative.empty()) return false;
+  if (totalClauses > maxOccurrences) return false;
+
+  // Tautologies are not added, so only the other resolvents count
+  resolvents.clear();
+  std::vector<int> resolvent;
+  for (unsigned p : positive) {
+    for (unsigned n : negative) {
+      if (!resolve(clauses[p], clauses[n], id, resolvent)) continue;
+      if (resolvent.size() > maxResolventSize) return false;
+      if (resolvents.size() == totalClauses) return false;
+      resolvents.push_back(resolvent);
+    }
+  }
+  return true;
+}
+
+bool Preprocessor::eliminateVariables() {
+  // Variables with fewer occurrences first, they are cheaper to eliminate
+  // and produce fewer resolvents
+  std::vector<unsigned> candidates;
+  for (unsigned id = 1; id <= totalVariables; id++) {
+    if (values[id - 1] == 0) candidates.push_back(id);
+  }
+  auto totalOccurrences = [&](unsigned id) {
+    return literalCount[literalIndex(id)] + literalCount[literalIndex(-id)];
+  };
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [&](unsigned a, unsigned b) {
+                     return totalOccurrences(a) < totalOccurrences(b);
+                   });
+
+  std::vector<std::vector<int>> resolvents;
+  for (unsigned id : candidates) {
+    if (values[id - 1] != 0 || eliminated[id - 1]) continue;
+    if (!boundedResolvents(id, resolvents)) continue;
+
+    // Store the positive clauses to extend the model and replace all the
+    // clauses of the variable by the resolvents
+    eliminated[id - 1] = true;
+    eliminatedVariables++;
+    std::vector<std::vector<int>> positiveClauses;
+    for (unsigned c : activeOccurrences(id)) {
+      positiveClauses.push_back(clauses[c]);
+      removeClause(c);
+    }
+    for (unsigned c : activeOccurrences(-id)) removeClause(c);
+    eliminationStack.push_back({id, std::move(positiveClauses)});
+
+    for (const std::vector<int>& literals : resolvents) {
+      if (!addClause(literals)) return false;
+    }
+    if (!propagate()) return false;
+  }
+  return true;
+}
+
+void Preprocessor::removeDuplicateClauses() {
+  std::vector<unsigned> order;
+  for (unsigned c = 0; c < clauses.size(); c++) {
+    if (!removed[c]) order.push_back(c);
+  }
+  std::sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+    return clauses[a] < clauses[b];
+  });
+
+  // The first clause of every group of equal clauses is kept. Its literals
+  // keep appearing, so no literal becomes pure
+  for (unsigned i = 1; i < order.size(); i++) {
+    if (clauses[order[i]] == clauses[order[i - 1]]) {
+      removeClause(order[i]);
+      duplicateClauses++;
+    }
+  }
+  pending.clear();
+}
+
+FactorGraph* Preprocessor::BuildGraph(GraphOrder order) const {
+  // Variables of the remaining clauses, numbered from 1 in the new graph
+  std::vector<unsigned> index(totalVariables, 0);
+  std::vector<unsigned> variableIds;
+  std::vector<int> literals;
+  for (unsigned c = 0; c < clauses.size(); c++) {
+    if (removed[c]) continue;
+    for (int literal : clauses[c]) {
+      unsigned id = std::abs(literal);
+      if (index[id - 1] == 0) {
+        variableIds.push_back(id);
+        index[id - 1] = variableIds.size();
+      }
+      literals.push_back(literal > 0 ? index[id - 1] : -index[id - 1]);
+    }
+    literals.push_back(0);
+  }
+
+  return new FactorGraph(variableIds, literals, order);
+}
+
+std::vector<bool> Preprocessor::ExtendModel(const FactorGraph& graph) const {
+  std::vector<bool> model(totalVariables, false);
+  for (unsigned v = 0; v < totalVariables; v++) {
+    if (values[v] != 0) model[v] = values[v] > 0;
+  }
+  for (Variable* var : graph.variables) model[var->id - 1] = var->value;
+
+  // Eliminated variables, from the last one. All the variables of their
+  // clauses already have their final value
+  for (auto it = eliminationStack.rbegin(); it != eliminationStack.rend();
+       it++) {
+    unsigned id = it->first;
+    model[id - 1] = false;
+    for (const std::vector<int>& literals : it->second) {
+      bool satisfied = false;
+      for (int literal : literals) {
+        if ((unsigned)std::abs(literal) != id &&
+            model[std::abs(literal) - 1] == (literal > 0))
+          satisfied = true;
+      }
+      if (!satisfied) {
+        model[id - 1] = true;
+        break;
+      }
+    }
+  }
+  return model;
+}
+
+bool Preprocessor::storeModel(const FactorGraph& graph,
+                              const std::string& filePath) const {
+  std::ofstream resultFile;
+  resultFile.open(filePath);
+  for (bool value : ExtendModel(graph)) {
+    resultFile << value << "\n";
+  }
+  resultFile.close();
+  return true;
+}
+
+unsigned Preprocessor::GetRemainingVariables() const {
+  std::vector<bool> appears(totalVariables, false);
+  for (unsigned c = 0; c < clauses.size(); c++) {
+    if (removed[c]) continue;
+    for (int literal : clauses[c]) appears[std::abs(literal) - 1] = true;
+  }
+  return std::count(appears.begin(), appears.end(), true);
+}
+
+unsigned Preprocessor::GetRemainingClauses() const {
+  return std::count(removed.begin(), removed.end(), false);
+}
+
+std::ostream& operator<<(std::ostream& os, const Preprocessor& pre) {
+  os << "Variables: " << pre.GetRemainingVariables() << "/"
+     << pre.GetOriginalVariables() << " - Clauses: "
+     << pre.GetRemainingClauses() << "/" << pre.GetOriginalClauses()
+     << std::endl;
+  os << " Duplicate literals: " << pre.duplicateLiterals << std::endl;
+  os << " Tautologies: " << pre.tautologies << std::endl;
+  os << " Unit literals: " << pre.unitLiterals << std::endl;
+  os << " Pure literals: " << pre.pureLiterals << std::endl;
+  os << " Eliminated variables: " << pre.eliminatedVariables << std::endl;
+  os << " Duplicate clauses: " << pre.duplicateClauses << std::endl;
+  return os;
+}
+
+}  // namespace sat
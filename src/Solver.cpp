@@ -1,21 +1,283 @@
 #include <Solver.hpp>
 #include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace sat {
 
 // =============================================================================
 // Solver
 // =============================================================================
-Solver::Solver(int N, double a, int seed)
-    : initialSeed(seed),
-      randomBoolUD(0, 1),
-      randomReal01UD(0, 1),
-      N(N),
-      alpha(a),
-      wsMaxFlips(100 * N) {
+Solver::Solver(int N, double a, int seed, unsigned long stream)
+    : initialSeed(seed), stream(stream), N(N), alpha(a), wsMaxFlips(100 * N) {
   // Random number generator initialization
   if (seed == 0) initialSeed = rd();
-  randomGenerator.seed(initialSeed);
+  randomGenerator.seed(initialSeed, stream);
+}
+
+void Solver::setSeed(unsigned long seed, unsigned long stream) {
+  initialSeed = seed;
+  this->stream = stream;
+  randomGenerator.seed(initialSeed, stream);
+}
+
+void Solver::setTimeLimit(double seconds) {
+  if (seconds <= 0) {
+    deadline = chrono::steady_clock::time_point::max();
+    return;
+  }
+  deadline = chrono::steady_clock::now() +
+             chrono::duration_cast<chrono::steady_clock::duration>(
+                 chrono::duration<double>(seconds));
+}
+
+void Solver::copyOptions(const Solver& other) {
+  sidFraction = other.sidFraction;
+  paramagneticState = other.paramagneticState;
+  spParamagneticCheck = other.spParamagneticCheck;
+  schedule = other.schedule;
+  minFraction = other.minFraction;
+  schedulePolarization = other.schedulePolarization;
+  scheduleIterations = other.scheduleIterations;
+  spMaxIt = other.spMaxIt;
+  spEpsilon = other.spEpsilon;
+  spDamping = other.spDamping;
+  spStallWindow = other.spStallWindow;
+  spDampingStep = other.spDampingStep;
+  spMaxDamping = other.spMaxDamping;
+  spAndersonDepth = other.spAndersonDepth;
+  spAndersonFallbacks = other.spAndersonFallbacks;
+  sweepOrder = other.sweepOrder;
+  sweepBlockSize = other.sweepBlockSize;
+  sweepPermutations = other.sweepPermutations;
+  components = other.components;
+  componentInterval = other.componentInterval;
+  componentMinVariables = other.componentMinVariables;
+  threads = other.threads;
+  wsMaxTries = other.wsMaxTries;
+  wsMaxFlips = other.wsMaxFlips;
+  wsNoise = other.wsNoise;
+}
+
+bool Solver::interrupted() {
+  if (interruption != CONVERGE) return true;
+  if (cancel && cancel->load(memory_order_relaxed))
+    interruption = INDETERMINATE;
+  else if (deadline != chrono::steady_clock::time_point::max() &&
+           chrono::steady_clock::now() >= deadline)
+    interruption = TIMEOUT;
+  return interruption != CONVERGE;
+}
+
+void Solver::reportProgress(unsigned unassignedVariables,
+                            unsigned enabledClauses, int unsatClauses) {
+  SolverProgress state;
+  state.round = totalSIDIterations;
+  state.unassignedVariables = unassignedVariables;
+  state.enabledClauses = enabledClauses;
+  state.lastSPIterations = lastSPIterations;
+  state.maxSurveyDiff = lastSurveyDiff;
+  state.walksatFlips = totalWSFlips;
+  state.unsatClauses = unsatClauses;
+  progress(state);
+}
+
+int Solver::countUnsatClauses(const FactorGraph* graph) {
+  int total = 0;
+  for (Clause* clause : graph->clauses) {
+    bool unsat = true;
+    for (Edge* edge : clause->allNeighbourEdges) {
+      Variable* var = edge->variable;
+      if (!var->assigned || edge->type == var->value) {
+        unsat = false;
+        break;
+      }
+    }
+    total += unsat;
+  }
+  return total;
+}
+
+void Solver::keepAssignment(int unsatClauses) {
+  if (bestUnsatClauses >= 0 && unsatClauses >= bestUnsatClauses) return;
+  bestUnsatClauses = unsatClauses;
+  bestLiterals.clear();
+  for (Variable* var : fg->variables) {
+    if (var->assigned) bestLiterals.push_back(var->value ? var->id : -var->id);
+  }
+}
+
+int Solver::GetBestAssignment(vector<int>& literals) const {
+  literals.clear();
+  if (fg == nullptr) return 0;
+  int current = countUnsatClauses(fg);
+  if (bestUnsatClauses >= 0 && bestUnsatClauses < current) {
+    literals = bestLiterals;
+    return bestUnsatClauses;
+  }
+  for (Variable* var : fg->variables) {
+    if (var->assigned) literals.push_back(var->value ? var->id : -var->id);
+  }
+  return current;
+}
+
+MemoryUsage Solver::GetMemoryUsage() const {
+  if (fg == nullptr) return EstimateMemoryUsage(0, 0);
+  unsigned permutations =
+      sweepOrder == SWEEP_PERMUTATIONS ? std::max(sweepPermutations, 1) : 0;
+  return EstimateMemoryUsage(fg->variables.size(), fg->clauses.size(),
+                             permutations);
+}
+
+MemoryUsage Solver::EstimateMemoryUsage(unsigned totalVariables,
+                                        unsigned totalClauses,
+                                        unsigned sweepPermutations) {
+  // Vectors of pointers filled with push_back, with capacity rounded up to
+  // the next power of 2
+  auto vectorSize = [](size_t size) {
+    size_t capacity = size ? 1 : 0;
+    while (capacity < size) capacity *= 2;
+    return HeapSize(capacity * sizeof(void*));
+  };
+
+  // SP: list of enabled clauses, sweep order and permutations (copies of
+  // the list with its exact size)
+  size_t spScratch = vectorSize(totalClauses) +
+                     (1 + sweepPermutations) *
+                         HeapSize(totalClauses * sizeof(void*));
+  // Decimation: candidates of every block of variables
+  size_t decimationScratch = vectorSize(totalVariables);
+  // Walksat: variables, clauses and unsat clauses of the subformula
+  size_t walksatScratch = vectorSize(totalVariables) +
+                          2 * vectorSize(totalClauses) + decimationScratch;
+
+  MemoryUsage usage;
+  usage.scratch = sizeof(Solver) +
+                  std::max(spScratch, std::max(decimationScratch,
+                                               walksatScratch));
+  return usage;
+}
+
+const char* Solver::ResultName(AlgorithmResult result) {
+  switch (result) {
+    case CONVERGE:
+      return "CONVERGE";
+    case UNCONVERGE:
+      return "UNCONVERGE";
+    case DONE:
+      return "DONE";
+    case CONTRADICTION:
+      return "CONTRADICTION";
+    case SAT:
+      return "SAT";
+    case INDETERMINATE:
+      return "INDETERMINATE";
+    case TIMEOUT:
+      return "TIMEOUT";
+    case WALKSAT:
+      return "WALKSAT";
+    default:
+      return "unknown";
+  }
+}
+
+const char* Solver::SweepOrderName(SweepOrder order) {
+  switch (order) {
+    case SWEEP_SHUFFLE:
+      return "shuffle";
+    case SWEEP_BLOCK_SHUFFLE:
+      return "block";
+    case SWEEP_PERMUTATIONS:
+      return "permutations";
+    case SWEEP_RANDOM_OFFSET:
+      return "offset";
+    default:
+      return "unknown";
+  }
+}
+
+bool Solver::ParseSweepOrder(const string& name, SweepOrder& order) {
+  for (int i = 0; i < TOTAL_SWEEP_ORDERS; i++) {
+    if (name == SweepOrderName((SweepOrder)i)) {
+      order = (SweepOrder)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* Solver::ScheduleName(DecimationSchedule schedule) {
+  switch (schedule) {
+    case SCHEDULE_FIXED:
+      return "fixed";
+    case SCHEDULE_ADAPTIVE:
+      return "adaptive";
+    default:
+      return "unknown";
+  }
+}
+
+bool Solver::ParseSchedule(const string& name, DecimationSchedule& schedule) {
+  for (int i = 0; i < TOTAL_SCHEDULES; i++) {
+    if (name == ScheduleName((DecimationSchedule)i)) {
+      schedule = (DecimationSchedule)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Solver::storeOptions(const string& filePath) const {
+  ofstream file(filePath);
+  if (!file.is_open()) return false;
+
+  file.precision(17);
+  file << "fraction=" << sidFraction << "\n";
+  file << "sp-max-it=" << spMaxIt << "\n";
+  file << "sp-epsilon=" << spEpsilon << "\n";
+  file << "paramagnetic=" << paramagneticState << "\n";
+  file << "ws-max-tries=" << wsMaxTries << "\n";
+  file << "ws-max-flips=" << wsMaxFlips << "\n";
+  file << "ws-noise=" << wsNoise << "\n";
+  return true;
+}
+
+bool Solver::loadOptions(const string& filePath) {
+  ifstream file(filePath);
+  if (!file.is_open()) return false;
+
+  string line;
+  while (getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    size_t separator = line.find('=');
+    if (separator == string::npos) return false;
+    string name = line.substr(0, separator);
+    const char* value = line.c_str() + separator + 1;
+    if (name == "fraction" && atof(value) > 0 && atof(value) <= 1) {
+      sidFraction = atof(value);
+    } else if (name == "sp-max-it" && atoi(value) > 0) {
+      spMaxIt = atoi(value);
+    } else if (name == "sp-epsilon" && atof(value) > 0) {
+      spEpsilon = atof(value);
+    } else if (name == "paramagnetic" && atof(value) >= 0) {
+      paramagneticState = atof(value);
+    } else if (name == "ws-max-tries" && atoi(value) > 0) {
+      wsMaxTries = atoi(value);
+    } else if (name == "ws-max-flips" && atoi(value) > 0) {
+      wsMaxFlips = atoi(value);
+    } else if (name == "ws-noise" && atof(value) >= 0 && atof(value) <= 1) {
+      wsNoise = atof(value);
+    } else {
+      return false;
+    }
+  }
+  return true;
 }
 
 // =============================================================================
@@ -26,9 +288,26 @@ AlgorithmResult Solver::SID(FactorGraph* graph, double fraction) {
   sidFraction = fraction;
   totalSPIterations = 0;
   totalSIDIterations = 0;
-
-  int assignFraction = (int)(N * fraction);
+  totalWSFlips = 0;
+  totalComponents = 0;
+  lastSPIterations = 0;
+  totalAssignments = 0;
+  totalSPStalls = 0;
+  totalSPAborts = 0;
+  totalSPExtrapolations = 0;
+  totalSPFallbacks = 0;
+  interruption = CONVERGE;
+  lastSurveyDiff = 0.0;
+  bestLiterals.clear();
+  bestUnsatClauses = -1;
+  metrics.Reset();
+
+  // The graph can be smaller than N if the formula has been simplified
+  int assignFraction = (int)(fg->variables.size() * fraction);
   if (assignFraction < 1) assignFraction = 1;
+  minAssignments = (int)(fg->variables.size() * minFraction);
+  if (minAssignments < 1) minAssignments = 1;
+  if (minAssignments > assignFraction) minAssignments = assignFraction;
 
   // --------------------------------
   // Random initialization of surveys
@@ -37,9 +316,20 @@ AlgorithmResult Solver::SID(FactorGraph* graph, double fraction) {
     edge->survey = getRandomReal01();
   }
 
+  // Independent parts of the formula are solved apart
+  AlgorithmResult componentsResult;
+  if (components && solveComponents(componentsResult)) return componentsResult;
+
   // Run until sat, sp unconverge or wlaksat result
   while (true) {
+    if (interrupted()) return interruption;
     totalSIDIterations++;
+    TraceSpan roundSpan(trace, "SID round");
+    roundSpan.AddArg("round", totalSIDIterations);
+    if (progress) {
+      reportProgress(fg->GetUnassignedVariables().size(),
+                     fg->GetEnabledClauses().size(), -1);
+    }
     // ----------------------------
     // Run SP
     // If trivial state is reach, walksat is called and the result returned
@@ -48,116 +338,475 @@ AlgorithmResult Solver::SID(FactorGraph* graph, double fraction) {
     if (spResult == WALKSAT) cout << fg << endl;
     if (spResult != CONVERGE) return spResult;
 
-    // --------------------------------
-    // Build variable list and order it
-    // --------------------------------
-    vector<Variable*> unassignedVariables;
+    // ----------------------------
+    // Decimate
+    // If paramagnetic state is reached, walksat is called and the result
+    // returned
+    // ----------------------------
+    AlgorithmResult decimationResult = decimate(assignFraction);
+    if (decimationResult != DONE) return decimationResult;
 
-    // Evaluate and store the sum of the max bias of all unassigned variables
-    double sumMaxBias = 0.0;
-    for (Variable* var : fg->variables) {
-      if (!var->assigned) {
-        evaluateVar(var);
-        // printf("X%d H.p:%f - H.m:%f\n", var->id, var->Hp, var->Hm);
-        // cout << "X" << var->id << " H.p:" << var->Hp << " - H.m:" << var->Hm
-        // << endl;
-        double maxBias = var->Hp > var->Hm ? var->Hp : var->Hm;
-        sumMaxBias += maxBias;
-        unassignedVariables.push_back(var);
-      }
+    // int postUnassignVars = fg->GetUnassignedVariables().size();
+    // int upAssignedVars =
+    //     prevUnsassignedVars - postUnassignVars - assignFraction;
+    // cout << "Assigned " << assignFraction << " variables (+" <<
+    // upAssignedVars
+    //      << " up)" << endl;
+
+    // ----------------------------
+    // If SAT finish algorithm
+    // ----------------------------
+    PhaseTimer isSATTimer(metrics, PHASE_IS_SAT);
+    bool isSAT = fg->IsSAT();
+    isSATTimer.Stop();
+    if (isSAT) {
+      return SAT;
     }
 
-    // int prevUnsassignedVars = unassignedVariables.size();
+    // Decimation can split the formula
+    if (components && totalSIDIterations % componentInterval == 0 &&
+        solveComponents(componentsResult))
+      return componentsResult;
+  }
+}
 
-    // printf("<bias>:%f\n", sumMaxBias / unassignedVariables.size());
-    // string a;
-    // cin >> a;
-    // Check paramagnetic state
-    // TODO: Entender que significa esto, en el codigo original, este es
-    // el unico sitio donde se llama a walksat
-    if (sumMaxBias / unassignedVariables.size() < paramagneticState) {
-      cout << "Paramagnetic state reached" << endl;
-      // cout << fg << endl;
-      return walksat();
+bool Solver::solveComponents(AlgorithmResult& result) {
+  TraceSpan componentsSpan(trace, "Components");
+
+  // ---------------------------------------------------
+  // Label the components with a BFS from every variable
+  // ---------------------------------------------------
+  unsigned maxVariableId = 0, maxClauseId = 0;
+  for (Variable* var : fg->variables)
+    maxVariableId = max(maxVariableId, var->id);
+  for (Clause* clause : fg->clauses) maxClauseId = max(maxClauseId, clause->id);
+  vector<int> variableComponent(maxVariableId + 1, -1);
+  vector<bool> visitedClause(maxClauseId + 1, false);
+
+  // Variables and clauses of every component, in BFS order
+  vector<vector<Variable*>> componentVariables;
+  vector<vector<Clause*>> componentClauses;
+  vector<Variable*> stack;
+  for (Variable* root : fg->variables) {
+    if (root->assigned || variableComponent[root->id] != -1) continue;
+
+    int component = componentVariables.size();
+    componentVariables.emplace_back();
+    componentClauses.emplace_back();
+    variableComponent[root->id] = component;
+    stack.push_back(root);
+    while (!stack.empty()) {
+      Variable* var = stack.back();
+      stack.pop_back();
+      componentVariables[component].push_back(var);
+
+      for (Edge* edge : var->allNeighbourEdges) {
+        Clause* clause = edge->clause;
+        if (!edge->enabled || !clause->enabled || visitedClause[clause->id])
+          continue;
+        visitedClause[clause->id] = true;
+        componentClauses[component].push_back(clause);
+
+        for (Edge* clauseEdge : clause->allNeighbourEdges) {
+          Variable* neighbour = clauseEdge->variable;
+          if (clauseEdge->enabled && !neighbour->assigned &&
+              variableComponent[neighbour->id] == -1) {
+            variableComponent[neighbour->id] = component;
+            stack.push_back(neighbour);
+          }
+        }
+      }
     }
+  }
 
-    // Assign minimum 1 variable
-    sort(unassignedVariables.begin(), unassignedVariables.end(),
-         [](const Variable* lvar, const Variable* rvar) {
-           return std::abs(lvar->evalValue) > std::abs(rvar->evalValue);
-         });
-
-    // cout << unassignedVariables[0]->id << ": "
-    //      << unassignedVariables[0]->evalValue << ", "
-    //      << unassignedVariables[1]->id << ": "
-    //      << unassignedVariables[1]->evalValue << ", "
-    //      << unassignedVariables[2]->id << ": "
-    //      << unassignedVariables[2]->evalValue << endl;
-
-    // ------------------------
-    // Fix the set of variables
-    // ------------------------
-    // int assignFraction = (int)(unassignedVariables.size() * fraction);
-    // if (assignFraction < 1) assignFraction = 1;
-    int auxAssign = assignFraction;
-    for (int i = 0; i < auxAssign; i++) {
-      // Variables in the list can be already assigned due to UP being executed
-      // in previous iterations
-      if (unassignedVariables[i]->assigned) {
-        auxAssign++;  // Don't count this variable as a new assignation
-        continue;
+  // ----------------------------------------------------------------
+  // Build the tasks: big components alone and small ones all together.
+  // Variables without enabled clauses don't need to be solved
+  // ----------------------------------------------------------------
+  vector<vector<int>> tasks;
+  vector<int> smallComponents;
+  for (unsigned c = 0; c < componentVariables.size(); c++) {
+    if (componentClauses[c].empty()) continue;
+    if ((int)componentVariables[c].size() >= componentMinVariables) {
+      tasks.push_back({(int)c});
+    } else {
+      smallComponents.push_back(c);
+    }
+  }
+  if (!smallComponents.empty()) tasks.push_back(smallComponents);
+  componentsSpan.AddArg("components", componentVariables.size());
+  componentsSpan.AddArg("tasks", tasks.size());
+  if (tasks.size() <= 1) return false;
+
+  // -----------------------------------------------------------------
+  // Build a graph and a solver for every task. Solvers get their own
+  // random streams and the parameters of this one
+  // -----------------------------------------------------------------
+  vector<FactorGraph*> graphs;
+  vector<Solver*> solvers;
+  vector<unsigned> localIndex(maxVariableId + 1, 0);
+  mutex progressMutex;
+  uint64_t seedState = initialSeed ^ (stream << 32) ^ totalSIDIterations;
+  for (const vector<int>& task : tasks) {
+    vector<unsigned> variableIds;
+    vector<int> literals;
+    unsigned clauseCount = 0;
+    for (int c : task) {
+      clauseCount += componentClauses[c].size();
+      for (Variable* var : componentVariables[c]) {
+        variableIds.push_back(var->id);
+        localIndex[var->id] = variableIds.size();
+      }
+      for (Clause* clause : componentClauses[c]) {
+        for (Edge* edge : clause->allNeighbourEdges) {
+          if (!edge->enabled) continue;
+          int index = localIndex[edge->variable->id];
+          literals.push_back(edge->type ? index : -index);
+        }
+        literals.push_back(0);
       }
+    }
+    graphs.push_back(new FactorGraph(variableIds, literals));
+
+    // The ratio of the component, not the one of the whole formula
+    Solver* solver = new Solver(variableIds.size(),
+                                (double)clauseCount / variableIds.size(), 1);
+    solver->setSeed(SplitMix64(seedState), 0);
+    solver->copyOptions(*this);
+    // The tasks are already solved in parallel
+    solver->threads = 1;
+    solver->metrics.enabled = metrics.enabled;
+    solver->cancel = cancel;
+    solver->deadline = deadline;
+    solver->keepBestAssignment = keepBestAssignment;
+    // The group of small components must not be split again
+    solver->components = components && task.size() == 1;
+    if (progress) {
+      // The tasks report to the callback of this solver one at a time
+      int component = solvers.size();
+      solver->progressFlips = progressFlips;
+      solver->progress = [this, component,
+                          &progressMutex](const SolverProgress& state) {
+        lock_guard<mutex> lock(progressMutex);
+        SolverProgress total = state;
+        total.component = component;
+        total.round += totalSIDIterations;
+        total.walksatFlips += totalWSFlips;
+        progress(total);
+      };
+    }
+    solvers.push_back(solver);
+  }
 
-      // Found the new value and assign the variable
-      // The assignation method cleans the graph and execute UP if one of
-      // the cleaned clause become unitary
-      Variable* var = unassignedVariables[i];
+  // ---------------------------
+  // Solve the tasks in parallel
+  // ---------------------------
+  vector<AlgorithmResult> results(tasks.size(), INDETERMINATE);
+  parallelFor(tasks.size(), [&](unsigned t) {
+    results[t] = solvers[t]->SID(graphs[t], sidFraction);
+  });
+
+  // ------------------------------------------------------------------
+  // Merge the assignments. The result is the first failure, if any.
+  // Failed tasks leave their best assignment, as WalkSAT does
+  // ------------------------------------------------------------------
+  vector<Variable*> variableById(maxVariableId + 1, nullptr);
+  for (Variable* var : fg->variables) variableById[var->id] = var;
+
+  result = SAT;
+  for (unsigned t = 0; t < tasks.size(); t++) {
+    totalSPIterations += solvers[t]->totalSPIterations;
+    totalWSFlips += solvers[t]->totalWSFlips;
+    totalComponents += max(solvers[t]->totalComponents, 1);
+    totalAssignments += solvers[t]->totalAssignments;
+    totalSPStalls += solvers[t]->totalSPStalls;
+    totalSPAborts += solvers[t]->totalSPAborts;
+    totalSPExtrapolations += solvers[t]->totalSPExtrapolations;
+    totalSPFallbacks += solvers[t]->totalSPFallbacks;
+    metrics += solvers[t]->metrics;
+
+    if (results[t] != SAT) {
+      if (result == SAT) result = results[t];
+      vector<int> literals;
+      solvers[t]->GetBestAssignment(literals);
+      for (int literal : literals)
+        variableById[std::abs(literal)]->AssignValue(literal > 0);
+      continue;
+    }
+    for (Variable* var : graphs[t]->variables) {
+      variableById[var->id]->AssignValue(var->value);
+    }
+  }
+  if (result != SAT && keepBestAssignment)
+    keepAssignment(countUnsatClauses(fg));
 
-      // Recalculate biases for same reason, previous assignations clean the
-      // graph and change relations
-      evaluateVar(var);
-      bool newValue = var->Hp > var->Hm ? false : true;
+  if (result == SAT) {
+    // Free variables can take any value
+    for (Variable* var : fg->variables) {
+      if (!var->assigned) var->AssignValue(false);
+    }
+    if (!fg->IsSAT()) result = INDETERMINATE;
+  }
 
-      if (!assignVariable(var, newValue)) {
-        // Error found when assigning variable
-        return CONTRADICTION;
-      }
+  for (FactorGraph* graph : graphs) delete graph;
+  for (Solver* solver : solvers) delete solver;
+  return true;
+}
+
+AlgorithmResult Solver::decimate(int assignFraction) {
+  // ------------------------------------------------------------------
+  // Evaluate the unassigned variables and select the candidates to fix
+  // ------------------------------------------------------------------
+  PhaseTimer biasTimer(metrics, PHASE_BIAS);
+
+  // Check paramagnetic state
+  // TODO: Entender que significa esto, en el codigo original, este es
+  // el unico sitio donde se llama a walksat
+  if (isParamagnetic()) {
+    biasTimer.Stop();
+    cout << "Paramagnetic state reached" << endl;
+    // cout << fg << endl;
+    return walksat();
+  }
+
+  // Variables assigned by UP while fixing the first candidates are skipped,
+  // so some more candidates than needed are selected
+  vector<Variable*> candidates;
+  unsigned polarized = evaluateVariables(2 * assignFraction, candidates);
+  if (schedule == SCHEDULE_ADAPTIVE)
+    assignFraction = scheduleAssignments(assignFraction, polarized);
+  biasTimer.Stop();
+
+  // cout << candidates[0]->id << ": " << candidates[0]->evalValue << ", "
+  //      << candidates[1]->id << ": " << candidates[1]->evalValue << ", "
+  //      << candidates[2]->id << ": " << candidates[2]->evalValue << endl;
+
+  // ------------------------
+  // Fix the set of variables
+  // ------------------------
+  // int assignFraction = (int)(unassignedVariables.size() * fraction);
+  // if (assignFraction < 1) assignFraction = 1;
+  PhaseTimer fixTimer(metrics, PHASE_FIX);
+  int fixed = 0;
+  unsigned next = 0;
+  while (fixed < assignFraction) {
+    // UP assigned more candidates than the spare ones: the next candidates
+    // are the best variables still unassigned, with the biases of the round
+    if (next == candidates.size()) {
+      selectUnassigned(2 * (assignFraction - fixed), candidates);
+      next = 0;
+      if (candidates.empty()) break;
     }
 
-    // int postUnassignVars = fg->GetUnassignedVariables().size();
-    // int upAssignedVars =
-    //     prevUnsassignedVars - postUnassignVars - assignFraction;
-    // cout << "Assigned " << assignFraction << " variables (+" <<
-    // upAssignedVars
-    //      << " up)" << endl;
+    // Variables in the list can be already assigned due to UP being executed
+    // in previous iterations
+    Variable* var = candidates[next++];
+    if (var->assigned) continue;
+    if (interrupted()) return interruption;
+
+    // Found the new value and assign the variable
+    // The assignation method cleans the graph and execute UP if one of
+    // the cleaned clause become unitary
+
+    // Recalculate biases for same reason, previous assignations clean the
+    // graph and change relations
+    evaluateVar(var);
+    bool newValue = var->Hp > var->Hm ? false : true;
+
+    TraceSpan upSpan(trace, "UP cascade");
+    upSpan.AddArg("variable", var->id);
+    totalAssignments++;
+    fixed++;
+    if (!assignVariable(var, newValue)) {
+      // Error found when assigning variable
+      return CONTRADICTION;
+    }
+  }
+  fixTimer.Stop();
 
-    // ----------------------------
-    // If SAT finish algorithm
-    // ----------------------------
-    if (fg->IsSAT()) {
-      return SAT;
+  return DONE;
+}
+
+// Order of the candidates: highest bias first, by id if equal
+static inline bool candidateBefore(const Variable* lvar, const Variable* rvar) {
+  return lvar->evalValue > rvar->evalValue ||
+         (lvar->evalValue == rvar->evalValue && lvar->id < rvar->id);
+}
+
+unsigned Solver::evaluateVariables(unsigned totalCandidates,
+                                   vector<Variable*>& candidates) {
+  // -----------------------------------------------------------------
+  // Map: every block of variables is evaluated apart, keeping its own
+  // best candidates and counting its polarized variables
+  // -----------------------------------------------------------------
+  const unsigned blockSize = 4096;
+  unsigned totalVariables = fg->variables.size();
+  unsigned totalBlocks = (totalVariables + blockSize - 1) / blockSize;
+  vector<vector<Variable*>> blockCandidates(totalBlocks);
+  vector<unsigned> blockPolarized(totalBlocks, 0);
+
+  parallelFor(totalBlocks, [&](unsigned b) {
+    vector<Variable*>& best = blockCandidates[b];
+    unsigned end = min(totalVariables, (b + 1) * blockSize);
+    for (unsigned v = b * blockSize; v < end; v++) {
+      Variable* var = fg->variables[v];
+      if (var->assigned) continue;
+      evaluateVar(var);
+      if (var->evalValue >= schedulePolarization) blockPolarized[b]++;
+      best.push_back(var);
+    }
+
+    if (best.size() > totalCandidates) {
+      nth_element(best.begin(), best.begin() + totalCandidates, best.end(),
+                  candidateBefore);
+      best.resize(totalCandidates);
     }
+  });
+
+  // ------------------------------------------------------------------
+  // Reduce: blocks are merged in order, so the result doesn't depend on
+  // the number of threads
+  // ------------------------------------------------------------------
+  unsigned polarized = 0;
+  candidates.clear();
+  for (unsigned b = 0; b < totalBlocks; b++) {
+    polarized += blockPolarized[b];
+    candidates.insert(candidates.end(), blockCandidates[b].begin(),
+                      blockCandidates[b].end());
+  }
+
+  unsigned totalSelected = min((unsigned)candidates.size(), totalCandidates);
+  partial_sort(candidates.begin(), candidates.begin() + totalSelected,
+               candidates.end(), candidateBefore);
+  candidates.resize(totalSelected);
+  return polarized;
+}
+
+void Solver::selectUnassigned(unsigned totalCandidates,
+                              vector<Variable*>& candidates) {
+  // The biases are the ones of evaluateVariables, all the variables still
+  // unassigned were evaluated by it
+  candidates.clear();
+  for (Variable* var : fg->variables) {
+    if (!var->assigned) candidates.push_back(var);
   }
+  unsigned totalSelected = min((unsigned)candidates.size(), totalCandidates);
+  partial_sort(candidates.begin(), candidates.begin() + totalSelected,
+               candidates.end(), candidateBefore);
+  candidates.resize(totalSelected);
+}
+
+int Solver::scheduleAssignments(int assignFraction, unsigned polarized) {
+  // SP needing many iterations means the surveys are less reliable
+  double assignments = polarized;
+  if (lastSPIterations > scheduleIterations)
+    assignments *= (double)scheduleIterations / lastSPIterations;
+
+  if (assignments < minAssignments) return minAssignments;
+  if (assignments > assignFraction) return assignFraction;
+  return (int)assignments;
+}
+
+void Solver::parallelFor(unsigned totalTasks,
+                         const function<void(unsigned)>& task) {
+  // Threads take the next task until all of them are done. The calling
+  // thread also runs tasks
+  atomic<unsigned> nextTask(0);
+  auto worker = [&]() {
+    for (unsigned t = nextTask++; t < totalTasks; t = nextTask++) task(t);
+  };
+
+  unsigned totalThreads = max(1, min(threads, (int)totalTasks));
+  vector<thread> pool;
+  for (unsigned i = 1; i < totalThreads; i++) pool.emplace_back(worker);
+  worker();
+  for (thread& t : pool) t.join();
 }
 
 AlgorithmResult Solver::surveyPropagation() {
+  TraceSpan spSpan(trace, "SP");
+  int firstIteration = totalSPIterations;
+
   // Calculate subproducts of all variables
   computeSubProducts();
+
+  // The enabled clauses don't change during SP, so they are collected once in
+  // the graph order and every iteration only changes the order of the sweep
+  vector<Clause*> enabledClauses = fg->GetEnabledClauses();
+  vector<Clause*> sweep(enabledClauses);
+  unsigned arity = clauseArity(enabledClauses);
+  vector<vector<Clause*>> permutations;
+  if (sweepOrder == SWEEP_PERMUTATIONS) {
+    permutations.assign(std::max(sweepPermutations, 1), enabledClauses);
+    for (vector<Clause*>& permutation : permutations) {
+      Shuffle(permutation.begin(), permutation.end(), randomGenerator);
+    }
+  }
+
+  // Best max survey difference and its iteration, for the oscillation
+  // detector
+  damping = spDamping;
+  double bestDiff = 1.0;
+  int bestIteration = 0;
+
+  // Anderson acceleration over the surveys of the edges updated by SP
+  vector<Edge*> updatedEdges;
+  vector<double> before, after, extrapolated;
+  unique_ptr<AndersonAcceleration> anderson;
+  bool extrapolatedLast = false;
+  double lastDiff = 1.0;
+  int fallbacks = 0;
+  if (spAndersonDepth > 0) {
+    for (Clause* clause : enabledClauses) {
+      for (Edge* edge : clause->allNeighbourEdges) {
+        if (edge->enabled && !edge->variable->assigned)
+          updatedEdges.push_back(edge);
+      }
+    }
+    anderson.reset(
+        new AndersonAcceleration(updatedEdges.size(), spAndersonDepth));
+  }
+
+  // No variable is assigned during SP, so the traced count is taken once
+  unsigned unassignedVariables = 0;
+  if (Configuration::instrumentation && trace)
+    unassignedVariables = fg->GetUnassignedVariables().size();
+
   for (int i = 0; i < spMaxIt; i++) {
+    if (interrupted()) {
+      lastSPIterations = totalSPIterations - firstIteration;
+      return interruption;
+    }
     totalSPIterations++;
+    PhaseTimer sweepTimer(metrics, PHASE_SP_SWEEP);
     // cout << "." << flush;
-    // Randomize clause iteration
-    vector<Clause*> enabledClauses = fg->GetEnabledClauses();
-    shuffle(enabledClauses.begin(), enabledClauses.end(), randomGenerator);
+    // Randomize clause iteration. Anderson acceleration needs the same map in
+    // every iteration, so the order is only drawn once
+    if (!anderson || i == 0)
+      orderSweep(enabledClauses, sweep, permutations, i);
+
+    if (anderson) readSurveys(updatedEdges, before);
 
     // Calculate surveys
-    double maxConvergeDiff = 0.0;
-    for (Clause* clause : enabledClauses) {
-      double maxConvDiffInClause = updateSurveys(clause);
+    double maxConvergeDiff = sweepSurveys(sweep, arity);
+    sweepTimer.Stop();
+
+    // A sweep stopped halfway doesn't tell if SP converged
+    if (interruption != CONVERGE) {
+      lastSPIterations = totalSPIterations - firstIteration;
+      return interruption;
+    }
+
+    // Damped updates only move the surveys part of the difference with the
+    // undamped ones, which is the one that must be below epsilon
+    if (damping > 0.0) maxConvergeDiff /= 1.0 - damping;
+    lastSurveyDiff = maxConvergeDiff;
 
-      // Save max convergence diff
-      if (maxConvDiffInClause > maxConvergeDiff)
-        maxConvergeDiff = maxConvDiffInClause;
+    if (Configuration::instrumentation && trace) {
+      trace->AddCounter("SP iteration",
+                        {{"enabled_clauses", enabledClauses.size()},
+                         {"unassigned_variables", unassignedVariables},
+                         {"max_survey_delta", maxConvergeDiff}});
     }
 
     // Check if converged
@@ -176,87 +825,287 @@ AlgorithmResult Solver::surveyPropagation() {
       // }
 
       // If not triavial return and continue algorith
+      // The tracker is only updated by the sweeps if it's checked in SP
+      if (!spParamagneticCheck) trackAllVariables();
+      lastSPIterations = totalSPIterations - firstIteration;
+      spSpan.AddArg("iterations", lastSPIterations);
       return CONVERGE;
     }
+
+    // The surveys can reach the trivial state before converging
+    if (spParamagneticCheck && isParamagnetic()) {
+      lastSPIterations = totalSPIterations - firstIteration;
+      spSpan.AddArg("iterations", lastSPIterations);
+      cout << "Paramagnetic state reached in SP" << endl;
+      return walksat();
+    }
+
+    // ------------------------------------------------------------------
+    // Anderson acceleration. An extrapolation that made the difference
+    // larger is reverted to the plain sweep before it
+    // ------------------------------------------------------------------
+    if (anderson) {
+      if (extrapolatedLast && maxConvergeDiff > lastDiff) {
+        totalSPFallbacks++;
+        totalSPExtrapolations--;
+        writeSurveys(updatedEdges, after);
+        computeSubProducts();
+        extrapolatedLast = false;
+        // Near an unstable fixed point the extrapolations hold the surveys
+        // close to it, so the rest of the call only uses plain sweeps
+        if (++fallbacks >= spAndersonFallbacks)
+          anderson.reset();
+        else
+          anderson->Restart();
+        continue;
+      }
+
+      readSurveys(updatedEdges, after);
+      extrapolatedLast = anderson->Extrapolate(before, after, extrapolated);
+      if (extrapolatedLast) {
+        totalSPExtrapolations++;
+        writeSurveys(updatedEdges, extrapolated);
+        computeSubProducts();
+      }
+      lastDiff = maxConvergeDiff;
+    }
+
+    // ---------------------------------------------------------------------
+    // Oscillation detector: no new minimum of the max difference in the
+    // last window. Raise the damping or abort if it can't be raised more
+    // ---------------------------------------------------------------------
+    if (spStallWindow > 0) {
+      if (maxConvergeDiff < bestDiff) {
+        bestDiff = maxConvergeDiff;
+        bestIteration = i;
+      } else if (i - bestIteration >= spStallWindow) {
+        totalSPStalls++;
+        if (damping >= spMaxDamping) {
+          totalSPAborts++;
+          lastSPIterations = totalSPIterations - firstIteration;
+          spSpan.AddArg("iterations", lastSPIterations);
+          spSpan.AddArg("aborted", 1);
+          return UNCONVERGE;
+        }
+        damping = min(damping + spDampingStep, spMaxDamping);
+        bestIteration = i;
+      }
+    }
   }
+  lastSPIterations = totalSPIterations - firstIteration;
+  spSpan.AddArg("iterations", lastSPIterations);
   // cout << ":-(" << endl;
   // Max itertions reach without convergence
   return UNCONVERGE;
 }
 
+void Solver::readSurveys(const vector<Edge*>& edges,
+                         vector<double>& surveys) const {
+  surveys.resize(edges.size());
+  for (unsigned i = 0; i < edges.size(); i++) surveys[i] = edges[i]->survey;
+}
+
+void Solver::writeSurveys(const vector<Edge*>& edges,
+                          const vector<double>& surveys) {
+  for (unsigned i = 0; i < edges.size(); i++) edges[i]->survey = surveys[i];
+}
+
+void Solver::orderSweep(const vector<Clause*>& clauses,
+                        vector<Clause*>& sweep,
+                        const vector<vector<Clause*>>& permutations,
+                        int iteration) {
+  unsigned size = clauses.size();
+  if (size == 0) return;
+
+  switch (sweepOrder) {
+    // The previous order is shuffled again
+    case SWEEP_SHUFFLE:
+      Shuffle(sweep.begin(), sweep.end(), randomGenerator);
+      break;
+
+    // Blocks of consecutive clauses are visited in random order, so the
+    // random accesses are only one per block
+    case SWEEP_BLOCK_SHUFFLE: {
+      unsigned blockSize = std::max(sweepBlockSize, 1);
+      vector<unsigned> blocks((size + blockSize - 1) / blockSize);
+      for (unsigned b = 0; b < blocks.size(); b++) blocks[b] = b * blockSize;
+      Shuffle(blocks.begin(), blocks.end(), randomGenerator);
+
+      vector<Clause*>::iterator out = sweep.begin();
+      for (unsigned begin : blocks) {
+        unsigned end = std::min(begin + blockSize, size);
+        out = std::copy(clauses.begin() + begin, clauses.begin() + end, out);
+      }
+      break;
+    }
+
+    // No random numbers are needed after the permutations are computed
+    case SWEEP_PERMUTATIONS: {
+      const vector<Clause*>& permutation =
+          permutations[iteration % permutations.size()];
+      std::copy(permutation.begin(), permutation.end(), sweep.begin());
+      break;
+    }
+
+    // Graph order rotated to a random clause, forwards or backwards
+    case SWEEP_RANDOM_OFFSET: {
+      unsigned offset = getRandomInt(size);
+      std::rotate_copy(clauses.begin(), clauses.begin() + offset,
+                       clauses.end(), sweep.begin());
+      if (getRandomBool()) std::reverse(sweep.begin(), sweep.end());
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
 void Solver::computeSubProducts() {
+  PhaseTimer timer(metrics, PHASE_SUBPRODUCTS);
   for (Variable* var : fg->variables) {
     if (!var->assigned) {
-      var->p = 1.0;
-      var->m = 1.0;
-      var->pzero = 0;
-      var->mzero = 0;
+      SubProducts::Reset(var->p, var->pzero);
+      SubProducts::Reset(var->m, var->mzero);
 
       // For each edge connecting the variable to a clause
       for (Edge* edge : var->allNeighbourEdges) {
         if (edge->enabled) {
           // If edge is negative update positive subproduct of variable
-          if (!edge->type) {
-            // If edge survey != 1
-            if (1.0 - edge->survey > ZERO_EPSILON) {
-              var->p *= 1.0 - edge->survey;
-            }
-            // If edge survey == 1
-            else
-              var->pzero++;
-          }
+          if (!edge->type)
+            SubProducts::Add(var->p, var->pzero, edge->survey);
           // If edge is positive, update negative subproduct of variable
-          else {
-            // If edge survey != 1
-            if (1.0 - edge->survey > ZERO_EPSILON) {
-              var->m *= 1.0 - edge->survey;
-            }
-            // If edge survey == 1
-            else
-              var->mzero++;
-          }
+          else
+            SubProducts::Add(var->m, var->mzero, edge->survey);
         }
       }
     }
   }
+
+  trackAllVariables();
+}
+
+// Max bias of a variable with its current subproducts, as in evaluateVar.
+// Variables with both subproducts 0 have no bias
+static inline double computeMaxBias(const Variable* var) {
+  double p = SubProducts::Product(var->p, var->pzero);
+  double m = SubProducts::Product(var->m, var->mzero);
+  double sum = p + m - p * m;
+  if (sum <= 0.0) return 0.0;
+  return (p > m ? p - p * m : m - p * m) / sum;
+}
+
+void Solver::trackVariable(Variable* var) {
+  double bias = computeMaxBias(var);
+  sumMaxBias += bias - var->maxBias;
+  var->maxBias = bias;
+}
+
+void Solver::trackAllVariables() {
+  sumMaxBias = 0.0;
+  trackedVariables = 0;
+  for (Variable* var : fg->variables) {
+    if (var->assigned) continue;
+    var->maxBias = computeMaxBias(var);
+    sumMaxBias += var->maxBias;
+    trackedVariables++;
+  }
+}
+
+bool Solver::isParamagnetic() const {
+  return trackedVariables > 0 &&
+         sumMaxBias / trackedVariables < paramagneticState;
+}
+
+double Solver::GetAverageMaxBias() const {
+  return trackedVariables > 0 ? sumMaxBias / trackedVariables : 0.0;
+}
+
+unsigned Solver::clauseArity(const vector<Clause*>& clauses) {
+  if (clauses.empty()) return 0;
+  unsigned arity = clauses[0]->allNeighbourEdges.size();
+  for (Clause* clause : clauses) {
+    if (clause->allNeighbourEdges.size() != arity) return 0;
+  }
+  return arity;
+}
+
+double Solver::sweepSurveys(const vector<Clause*>& clauses, unsigned arity) {
+  // Policy compiled for the formula and the options of this sweep
+  if (arity == 3) {
+    if (damping > 0.0)
+      return spParamagneticCheck
+                 ? sweepSurveys<SweepPolicy<3, true, true>>(clauses)
+                 : sweepSurveys<SweepPolicy<3, true, false>>(clauses);
+    return spParamagneticCheck
+               ? sweepSurveys<SweepPolicy<3, false, true>>(clauses)
+               : sweepSurveys<SweepPolicy<3, false, false>>(clauses);
+  }
+  if (damping > 0.0)
+    return spParamagneticCheck
+               ? sweepSurveys<SweepPolicy<0, true, true>>(clauses)
+               : sweepSurveys<SweepPolicy<0, true, false>>(clauses);
+  return spParamagneticCheck
+             ? sweepSurveys<SweepPolicy<0, false, true>>(clauses)
+             : sweepSurveys<SweepPolicy<0, false, false>>(clauses);
 }
 
+template <class Policy>
+double Solver::sweepSurveys(const vector<Clause*>& clauses) {
+  double maxConvergeDiff = 0.0;
+  unsigned totalClauses = clauses.size();
+  for (unsigned c = 0; c < totalClauses; c++) {
+    // Large sweeps can be stopped every block of clauses
+    if ((c & 1023) == 1023 && interrupted()) break;
+    double maxConvDiffInClause = updateSurveys<Policy>(clauses[c]);
+
+    // Save max convergence diff
+    if (maxConvDiffInClause > maxConvergeDiff)
+      maxConvergeDiff = maxConvDiffInClause;
+  }
+  return maxConvergeDiff;
+}
+
+template <class Policy>
 double Solver::updateSurveys(Clause* clause) {
+  const EdgeList& edges = clause->allNeighbourEdges;
+  unsigned size = Policy::arity ? Policy::arity : edges.size();
   double maxConvDiffInClause = 0.0;
   int zeros = 0;
   double allSubSurveys = 1.0;
-  vector<double> subSurveys;
+
+  // Sub surveys on the stack, except for clauses longer than the buffer
+  // with any arity
+  double buffer[Policy::arity ? Policy::arity : 8];
+  vector<double> longClause;
+  double* subSurveys = buffer;
+  if (!Policy::arity && size > 8) {
+    longClause.resize(size);
+    subSurveys = longClause.data();
+  }
+  int total = 0;
 
   // ==================================================================
   // Calculate subProducts of all literals and keep track of wich are 0
   // ==================================================================
-  for (Edge* edge : clause->allNeighbourEdges) {
+  for (unsigned k = 0; k < size; k++) {
+    Edge* edge = edges[k];
     if (edge->enabled && !edge->variable->assigned) {
       Variable* var = edge->variable;
       double m, p, wn, wt;
 
       // If edge is negative:
       if (!edge->type) {
-        m = var->mzero ? 0 : var->m;
-        if (var->pzero == 0)
-          p = var->p / (1.0 - edge->survey);
-        else if (var->pzero == 1 && (1.0 - edge->survey) < ZERO_EPSILON)
-          p = var->p;
-        else
-          p = 0.0;
+        m = SubProducts::Product(var->m, var->mzero);
+        p = SubProducts::Without(var->p, var->pzero, edge->survey);
 
         wn = p * (1.0 - m);
         wt = m;
       }
       // If edge is positive
       else {
-        p = var->pzero ? 0 : var->p;
-        if (var->mzero == 0)
-          m = var->m / (1.0 - edge->survey);
-        else if (var->mzero == 1 && (1.0 - edge->survey) < ZERO_EPSILON)
-          m = var->m;
-        else
-          m = 0.0;
+        p = SubProducts::Product(var->p, var->pzero);
+        m = SubProducts::Without(var->m, var->mzero, edge->survey);
 
         wn = m * (1 - p);
         wt = p;
@@ -264,7 +1113,7 @@ double Solver::updateSurveys(Clause* clause) {
 
       // Calculate subSurvey
       double subSurvey = wn / (wn + wt);
-      subSurveys.push_back(subSurvey);
+      subSurveys[total++] = subSurvey;
 
       // If subsurvey is 0 keep track but don't multiply
       if (subSurvey < ZERO_EPSILON) {
@@ -279,7 +1128,8 @@ double Solver::updateSurveys(Clause* clause) {
   // Calculate the survey for each edge with the previous data
   // =========================================================
   int i = 0;
-  for (Edge* edge : clause->allNeighbourEdges) {
+  for (unsigned k = 0; k < size; k++) {
+    Edge* edge = edges[k];
     if (edge->enabled && !edge->variable->assigned) {
       // ---------------------------------------------
       // Calculate new survey from sub survey products
@@ -295,58 +1145,25 @@ double Solver::updateSurveys(Clause* clause) {
       else
         newSurvey = 0.0;
 
+      // Keep part of the previous survey
+      if (Policy::damped)
+        newSurvey = damping * edge->survey + (1.0 - damping) * newSurvey;
+
+      // Round to the stored precision, so the subproducts are updated with
+      // the same value that is stored in the edge
+      newSurvey = Survey(newSurvey);
+
       // ----------------------------------------------------
       // Update the variable subproducts with new survey info
       // ----------------------------------------------------
       Variable* var = edge->variable;
-      // If edge is negative update positive subproduct
-      if (!edge->type) {
-        // If previous survey != 1 (with an epsilon margin)
-        if (1.0 - edge->survey > ZERO_EPSILON) {
-          // If new survey != 1, update the sub product with the difference
-          if (1.0 - newSurvey > ZERO_EPSILON)
-            var->p *= ((1.0 - newSurvey) / (1.0 - edge->survey));
-          // If new survey == 1, update the subproduct by remove the old survey
-          // and keep track of the new survey == 1 (pzero++)
-          else {
-            var->p /= (1.0 - edge->survey);
-            var->pzero++;
-          }
-        }
-        // If previous survey == 1
-        else {
-          // If new survey == 1, don't do anything (both surveys are the same)
-          // If new survey != 1, update subproduct
-          if (1.0 - newSurvey > ZERO_EPSILON) {
-            var->p *= (1.0 - newSurvey);
-            var->pzero--;
-          }
-        }
-      }
-      // If edge is positive, update negative subproduct
-      else {
-        // If previous survey != 1 (with an epsilon margin)
-        if (1.0 - edge->survey > ZERO_EPSILON) {
-          // If new survey != 1, update the sub product with the difference
-          if (1.0 - newSurvey > ZERO_EPSILON)
-            var->m *= ((1.0 - newSurvey) / (1.0 - edge->survey));
-          // If new survey == 1, update the subproduct by remove the old survey
-          // and keep track of the new survey == 1 (pzero++)
-          else {
-            var->m /= (1.0 - edge->survey);
-            var->mzero++;
-          }
-        }
-        // If previous survey == 1
-        else {
-          // If new survey == 1, don't do anything (both surveys are the same)
-          // If new survey != 1, update subproduct
-          if (1.0 - newSurvey > ZERO_EPSILON) {
-            var->m *= (1.0 - newSurvey);
-            var->mzero--;
-          }
-        }
-      }
+      // If edge is negative update positive subproduct, else the negative
+      if (!edge->type)
+        SubProducts::Update(var->p, var->pzero, edge->survey, newSurvey);
+      else
+        SubProducts::Update(var->m, var->mzero, edge->survey, newSurvey);
+
+      if (Policy::tracked) trackVariable(var);
 
       // ----------------------------------------------------
       // Store new survey and update max clause converge diff
@@ -370,6 +1187,13 @@ bool Solver::assignVariable(Variable* var, bool value) {
     return false;
   }
 
+  // The variable leaves the paramagnetic tracker
+  if (!var->assigned && trackedVariables > 0) {
+    sumMaxBias -= var->maxBias;
+    var->maxBias = 0.0;
+    trackedVariables--;
+  }
+
   var->AssignValue(value);
   return cleanGraph(var);
 }
@@ -392,6 +1216,7 @@ bool Solver::cleanGraph(Variable* var) {
 }
 
 bool Solver::unitPropagation(Clause* clause) {
+  PhaseTimer timer(metrics, PHASE_UP);
   vector<Edge*> enabledEdges = clause->GetEnabledEdges();
   int size = enabledEdges.size();
 
@@ -413,8 +1238,8 @@ bool Solver::unitPropagation(Clause* clause) {
 }
 
 void Solver::evaluateVar(Variable* var) {
-  double p = var->pzero ? 0 : var->p;
-  double m = var->mzero ? 0 : var->m;
+  double p = SubProducts::Product(var->p, var->pzero);
+  double m = SubProducts::Product(var->m, var->mzero);
 
   var->Hz = p * m;
   var->Hp = m - var->Hz;
@@ -440,6 +1265,8 @@ AlgorithmResult Solver::walksat() {
 
   vector<Clause*> unsatClauses;
   for (int t = 0; t < wsMaxTries; t++) {
+    TraceSpan trySpan(trace, "WalkSAT try");
+    trySpan.AddArg("try", t);
     // Assign all Varibles with random values
     for (Variable* var : variables) {
       var->AssignValue(getRandomBool());
@@ -450,17 +1277,22 @@ AlgorithmResult Solver::walksat() {
     for (Clause* clause : clauses) {
       if (clause->countTrueLiterals() == 0) unsatClauses.push_back(clause);
     }
+    if (keepBestAssignment) keepAssignment(unsatClauses.size());
 
     for (int f = 0; f < wsMaxFlips; f++) {
       // If there are no unsat clauses, subgraph is solved and it's SAT
       if (unsatClauses.size() == 0) return SAT;
+      if (interrupted()) return interruption;
+      PhaseTimer flipTimer(metrics, PHASE_WALKSAT_FLIP);
+      totalWSFlips++;
 
       // Select random unsat clause
-      std::uniform_int_distribution<> randomInt(0, unsatClauses.size() - 1);
-      int randIndex = randomInt(randomGenerator);
+      int randIndex = getRandomInt(unsatClauses.size());
       Clause* selectedClause = unsatClauses[randIndex];
       std::vector<Edge*> selectedClauseEdges =
           selectedClause->GetEnabledEdges();
+      // No literal can satisfy the clause
+      if (selectedClauseEdges.empty()) return CONTRADICTION;
 
       // -----------------------------------------------------------------------
       // For each variable in selected clause, calculate break-count (number of
@@ -469,7 +1301,7 @@ AlgorithmResult Solver::walksat() {
       // Fast-walksat is used to compute break-count
       // -----------------------------------------------------------------------
       vector<Variable*> lowestBreakCountVar;
-      int lowestBreakCount = N * alpha + 1;
+      int lowestBreakCount = INT_MAX;
       for (Edge* edge : selectedClauseEdges) {
         int breakCount = 0;
         for (Edge* e : edge->variable->allNeighbourEdges) {
@@ -510,16 +1342,13 @@ AlgorithmResult Solver::walksat() {
         if (lowestBreakCountVar.size() == 1) {
           var = lowestBreakCountVar[0];
         } else {
-          uniform_int_distribution<> randi(0, lowestBreakCountVar.size() - 1);
-          int i = randi(randomGenerator);
+          int i = getRandomInt(lowestBreakCountVar.size());
           var = lowestBreakCountVar[i];
         }
       }
       // Select random var with probability p
       else {
-        std::uniform_int_distribution<> randEdgeIndexDist(
-            0, selectedClauseEdges.size() - 1);
-        int randomEdgeIndex = randEdgeIndexDist(randomGenerator);
+        int randomEdgeIndex = getRandomInt(selectedClauseEdges.size());
         var = selectedClauseEdges[randomEdgeIndex]->variable;
       }
 
@@ -541,6 +1370,10 @@ AlgorithmResult Solver::walksat() {
         if (e->enabled && e->clause->countTrueLiterals() == 0)
           unsatClauses.push_back(e->clause);
       }
+      if (keepBestAssignment) keepAssignment(unsatClauses.size());
+
+      if (progress && progressFlips > 0 && totalWSFlips % progressFlips == 0)
+        reportProgress(variables.size(), clauses.size(), unsatClauses.size());
     }
   }
 
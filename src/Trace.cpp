@@ -0,0 +1,63 @@
+#include <fstream>
+#include <iomanip>
+
+// Project headers
+#include <Trace.hpp>
+
+namespace sat {
+
+// =============================================================================
+// Trace
+// =============================================================================
+Trace::Trace() { Clear(); }
+
+double Trace::Now() const {
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(now - origin)
+             .count() /
+         1000.0;
+}
+
+void Trace::AddSpan(const char* name, double begin,
+                    std::vector<std::pair<const char*, double>> args) {
+  events.push_back({name, 'X', begin, Now() - begin, std::move(args)});
+}
+
+void Trace::AddCounter(const char* name,
+                       std::vector<std::pair<const char*, double>> args) {
+  events.push_back({name, 'C', Now(), 0.0, std::move(args)});
+}
+
+void Trace::Clear() {
+  events.clear();
+  origin = std::chrono::steady_clock::now();
+}
+
+bool Trace::storeJSON(const std::string& filePath) const {
+  std::ofstream file(filePath);
+  if (!file.is_open()) return false;
+
+  file << std::fixed << std::setprecision(3);
+  file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  for (unsigned i = 0; i < events.size(); i++) {
+    const TraceEvent& event = events[i];
+    if (i > 0) file << ",";
+    file << "\n{\"name\": \"" << event.name << "\", \"ph\": \""
+         << event.phase << "\", \"pid\": 1, \"tid\": 1, \"ts\": " << event.ts;
+    if (event.phase == 'X') file << ", \"dur\": " << event.dur;
+
+    file << ", \"args\": {";
+    for (unsigned j = 0; j < event.args.size(); j++) {
+      if (j > 0) file << ", ";
+      file << "\"" << event.args[j].first << "\": ";
+      file << std::defaultfloat << std::setprecision(10)
+           << event.args[j].second;
+      file << std::fixed << std::setprecision(3);
+    }
+    file << "}}";
+  }
+  file << "\n]}\n";
+  return true;
+}
+
+}  // namespace sat
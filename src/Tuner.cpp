@@ -0,0 +1,227 @@
+#include <Tuner.hpp>
+#include <Preprocessor.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace sat {
+
+// =============================================================================
+// TunerCandidate
+// =============================================================================
+void TunerCandidate::Read(const Solver& solver) {
+  fraction = solver.sidFraction;
+  spEpsilon = solver.spEpsilon;
+  paramagneticState = solver.paramagneticState;
+  wsNoise = solver.wsNoise;
+  wsMaxFlips = solver.wsMaxFlips;
+}
+
+void TunerCandidate::Apply(Solver& solver) const {
+  solver.sidFraction = fraction;
+  solver.spEpsilon = spEpsilon;
+  solver.paramagneticState = paramagneticState;
+  solver.wsNoise = wsNoise;
+  solver.wsMaxFlips = wsMaxFlips;
+}
+
+bool TunerCandidate::Before(const TunerCandidate& other) const {
+  if (rounds != other.rounds) return rounds > other.rounds;
+  if (solved != other.solved) return solved > other.solved;
+  return seconds < other.seconds;
+}
+
+// =============================================================================
+// Tuner
+// =============================================================================
+Tuner::Tuner(const std::vector<std::string>& instances, int N, double a,
+             unsigned long seed)
+    : instances(instances), N(N), alpha(a), seed(seed) {
+  if (seed == 0) this->seed = std::random_device()();
+}
+
+TunerCandidate Tuner::Run(const std::function<void(Solver&)>& configure) {
+  // ------------------------------------------------------
+  // Candidates: the base options and the random samples
+  // ------------------------------------------------------
+  Solver base(N, alpha, seed);
+  configure(base);
+  candidates.assign(1, TunerCandidate());
+  candidates[0].Read(base);
+
+  RandomEngine engine(seed);
+  auto logUniform = [&](double min, double max) {
+    return min * std::pow(max / min, RandomReal01(engine));
+  };
+  for (int c = 0; c < configs; c++) {
+    TunerCandidate candidate;
+    candidate.fraction = logUniform(minFraction, maxFraction);
+    candidate.spEpsilon = logUniform(minEpsilon, maxEpsilon);
+    candidate.paramagneticState = logUniform(minParamagnetic, maxParamagnetic);
+    candidate.wsNoise = minNoise + (maxNoise - minNoise) * RandomReal01(engine);
+    candidate.wsMaxFlips = (int)(N * logUniform(minFlipsPerVariable,
+                                                maxFlipsPerVariable));
+    candidates.push_back(candidate);
+  }
+
+  // ------------------------------------------------------
+  // Successive halving: the first round uses the instances
+  // needed to reach all of them when one candidate is left
+  // ------------------------------------------------------
+  unsigned totalRounds = 0;
+  while ((1u << totalRounds) < candidates.size()) totalRounds++;
+  unsigned totalInstances = instances.size();
+  unsigned roundInstances = std::max(1u, totalInstances >> totalRounds);
+
+  std::vector<TunerCandidate*> round;
+  for (TunerCandidate& candidate : candidates) round.push_back(&candidate);
+  while (true) {
+    if (!solve(round, roundInstances, configure)) {
+      graphs.clear();
+      refuted.clear();
+      baseSeconds.clear();
+      candidates.resize(1);
+      return candidates[0];
+    }
+    for (TunerCandidate* candidate : round) candidate->rounds++;
+    std::sort(round.begin(), round.end(),
+              [](const TunerCandidate* a, const TunerCandidate* b) {
+                return a->Before(*b);
+              });
+    if (round.size() == 1) break;
+
+    round.resize((round.size() + 1) / 2);
+    roundInstances = std::min(totalInstances, 2 * roundInstances);
+  }
+  graphs.clear();
+  refuted.clear();
+  baseSeconds.clear();
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const TunerCandidate& a, const TunerCandidate& b) {
+              return a.Before(b);
+            });
+  return candidates[0];
+}
+
+bool Tuner::load(unsigned instance) {
+  std::ifstream file(instances[instance]);
+  if (!file.is_open()) return false;
+  if (!preprocess) {
+    graphs[instance].reset(new FactorGraph(file, graphOrder));
+    return true;
+  }
+
+  // The original graph is only needed to read the clauses
+  FactorGraph original(file);
+  Preprocessor preprocessor(original);
+  preprocessor.variableElimination = variableElimination;
+  refuted[instance] = !preprocessor.Run();
+  if (!refuted[instance])
+    graphs[instance].reset(preprocessor.BuildGraph(graphOrder));
+  return true;
+}
+
+bool Tuner::solve(const std::vector<TunerCandidate*>& round,
+                  unsigned totalInstances,
+                  const std::function<void(Solver&)>& configure) {
+  // Instances of the round, loaded once. The workers solve clones of them
+  graphs.resize(instances.size());
+  refuted.resize(instances.size(), false);
+  baseSeconds.resize(instances.size(), -1.0);
+  for (unsigned i = 0; i < totalInstances; i++) {
+    if (graphs[i] || refuted[i]) continue;
+    if (!load(i)) return false;
+  }
+
+  // Run of a candidate on an instance, stopped after seconds (0: no limit)
+  struct Run {
+    TunerCandidate* candidate;
+    unsigned instance;
+    double limit;
+    AlgorithmResult result;
+    double seconds;
+  };
+
+  // Workers take the next run until all of them are done. The calling
+  // thread is also a worker
+  auto execute = [&](std::vector<Run>& runs) {
+    std::atomic<unsigned> nextRun(0);
+    auto worker = [&](unsigned stream) {
+      Solver solver(N, alpha, seed, stream);
+      configure(solver);
+      solver.threads = 1;
+      std::vector<std::unique_ptr<FactorGraph>> clones(instances.size());
+
+      for (unsigned r = nextRun++; r < runs.size(); r = nextRun++) {
+        Run& run = runs[r];
+        if (refuted[run.instance]) continue;
+        std::unique_ptr<FactorGraph>& graph = clones[run.instance];
+        if (!graph)
+          graph.reset(graphs[run.instance]->Clone());
+        else
+          graph->Reset();
+
+        // The stream of the instance, the same for every candidate
+        run.candidate->Apply(solver);
+        solver.setSeed(seed, run.instance + 1);
+        solver.setTimeLimit(run.limit);
+        auto begin = std::chrono::steady_clock::now();
+        run.result = solver.SID(graph.get());
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - begin;
+        run.seconds = elapsed.count();
+      }
+    };
+
+    unsigned totalThreads = std::max(1, std::min(threads, (int)runs.size()));
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < totalThreads; t++) pool.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& t : pool) t.join();
+  };
+
+  // The base candidate solves the new instances first, to know the deadlines
+  // of the others. Its runs only count while it takes part in the round
+  TunerCandidate* base = &candidates[0];
+  std::vector<Run> baseRuns;
+  for (unsigned i = 0; i < totalInstances; i++) {
+    if (baseSeconds[i] < 0)
+      baseRuns.push_back({base, i, timeout, CONTRADICTION, 0.0});
+  }
+  execute(baseRuns);
+  for (const Run& run : baseRuns) baseSeconds[run.instance] = run.seconds;
+
+  // Runs of the other candidates: the instances they have not solved yet
+  std::vector<Run> runs;
+  bool baseInRound = false;
+  for (TunerCandidate* candidate : round) {
+    if (candidate == base) {
+      baseInRound = true;
+      continue;
+    }
+    for (unsigned i = candidate->instances; i < totalInstances; i++) {
+      double limit = std::max(minSeconds, timeFactor * baseSeconds[i]);
+      if (timeout > 0) limit = std::min(limit, timeout);
+      runs.push_back({candidate, i, limit, CONTRADICTION, 0.0});
+    }
+  }
+  execute(runs);
+
+  if (baseInRound) runs.insert(runs.end(), baseRuns.begin(), baseRuns.end());
+  for (const Run& run : runs) {
+    run.candidate->solved += run.result == SAT;
+    run.candidate->timeouts += run.result == TIMEOUT;
+    run.candidate->seconds += run.seconds;
+  }
+  for (TunerCandidate* candidate : round)
+    candidate->instances = std::max(candidate->instances, totalInstances);
+  return true;
+}
+
+}  // namespace sat
@@ -2,9 +2,8 @@
 #include <iostream>
 
 // Project headders
-#include <Algorithms.hpp>
 #include <FactorGraph.hpp>
-#include <Utils.hpp>
+#include <Solver.hpp>
 
 TEST_CASE("Algorithm - SID (prueba)", "[prueba]") {
   std::ifstream file("./test/cnf/prueba.cnf");
@@ -12,15 +11,12 @@ TEST_CASE("Algorithm - SID (prueba)", "[prueba]") {
   sat::FactorGraph* graph = new sat::FactorGraph(file);
   file.close();
 
-  // sat::utils::RandomGen::setSeed(7357);
+  sat::Solver solver(8, 9.0 / 8, 7357);
 
-  sat::SIDResult result = sat::SID(graph, 0.0f);
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  REQUIRE(result.SAT);
-  // REQUIRE(result.totalSPIterations == 5);
+  REQUIRE(result == sat::SAT);
+  CHECK(graph->IsSAT());
 
-  // std::vector<sat::Variable*> variables = graph->GetAllVariables();
-  // CHECK_FALSE(variables[0]->value);
-  // CHECK(variables[1]->value);
-  // CHECK(variables[2]->value);
+  delete graph;
 };
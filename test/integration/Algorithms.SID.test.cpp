@@ -2,9 +2,8 @@
 #include <iostream>
 
 // Project headders
-#include <Algorithms.hpp>
 #include <FactorGraph.hpp>
-#include <Utils.hpp>
+#include <Solver.hpp>
 
 TEST_CASE("Algorithm - SID (walksat solution)", "[integration]") {
   std::ifstream file("./test/cnf/1.cnf");
@@ -12,15 +11,13 @@ TEST_CASE("Algorithm - SID (walksat solution)", "[integration]") {
   sat::FactorGraph* graph = new sat::FactorGraph(file);
   file.close();
 
-  sat::utils::RandomGen::setSeed(7357);
+  sat::Solver solver(3, 1.0, 7357);
 
-  sat::SIDResult result = sat::SID(graph, 0.0f);
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  REQUIRE(result.SAT);
-  REQUIRE(result.totalSPIterations == 5);
+  REQUIRE(result == sat::SAT);
+  REQUIRE(solver.totalSPIterations > 0);
+  CHECK(graph->IsSAT());
 
-  std::vector<sat::Variable*> variables = graph->GetAllVariables();
-  CHECK_FALSE(variables[0]->value);
-  CHECK(variables[1]->value);
-  CHECK(variables[2]->value);
+  delete graph;
 };
@@ -2,9 +2,8 @@
 #include <iostream>
 
 // Project headders
-#include <Algorithms.hpp>
 #include <FactorGraph.hpp>
-#include <Utils.hpp>
+#include <Solver.hpp>
 
 TEST_CASE("Algorithm - Survey Propagation (converge)", "[integration]") {
   std::ifstream file("./test/cnf/1.cnf");
@@ -12,14 +11,19 @@ TEST_CASE("Algorithm - Survey Propagation (converge)", "[integration]") {
   sat::FactorGraph* graph = new sat::FactorGraph(file);
   file.close();
 
-  sat::utils::RandomGen::setSeed(7357);
+  // SP converges to the trivial state in the first round, and SID stops
+  // without assigning any variable
+  sat::Solver solver(3, 1.0, 7357);
+  solver.wsMaxTries = 0;
 
-  sat::SPResult result = sat::SurveyPropagation(graph);
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  for (sat::Edge* edge : graph->GetEnabledEdges()) {
-    CHECK(edge->survey < 0.0001f);
+  REQUIRE(result != sat::UNCONVERGE);
+  REQUIRE(solver.totalSIDIterations == 1);
+  REQUIRE(solver.totalSPIterations < solver.spMaxIt);
+  for (sat::Edge* edge : graph->edges) {
+    CHECK(edge->survey < 0.0001);
   }
 
-  REQUIRE(result.converged);
-  REQUIRE(result.iterations == 3);
-};
\ No newline at end of file
+  delete graph;
+};
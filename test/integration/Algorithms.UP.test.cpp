@@ -1,10 +1,10 @@
 #include <catch2/catch.hpp>
 #include <iostream>
+#include <sstream>
 
 // Project headders
-#include <Algorithms.hpp>
 #include <FactorGraph.hpp>
-#include <Utils.hpp>
+#include <Solver.hpp>
 
 TEST_CASE("Algorithm - Unit Propagation (no unit clauses)", "[integration]") {
   std::ifstream file("./test/cnf/1.cnf");
@@ -12,11 +12,13 @@ TEST_CASE("Algorithm - Unit Propagation (no unit clauses)", "[integration]") {
   sat::FactorGraph* graph = new sat::FactorGraph(file);
   file.close();
 
-  sat::utils::RandomGen::setSeed(7357);
+  sat::Solver solver(graph->variables.size(), 1.0, 7357);
 
-  bool result = sat::UnitPropagation(graph);
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  CHECK(result);
+  CHECK(result == sat::SAT);
+
+  delete graph;
 };
 
 TEST_CASE("Algorithm - Unit Propagation (1 propagation)", "[integration]") {
@@ -25,11 +27,13 @@ TEST_CASE("Algorithm - Unit Propagation (1 propagation)", "[integration]") {
   sat::FactorGraph* graph = new sat::FactorGraph(file);
   file.close();
 
-  sat::utils::RandomGen::setSeed(7357);
+  sat::Solver solver(graph->variables.size(), 1.0, 7357);
+
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  bool result = sat::UnitPropagation(graph);
+  CHECK(result == sat::SAT);
 
-  CHECK(result);
+  delete graph;
 };
 
 TEST_CASE("Algorithm - Unit Propagation (2 propagation)", "[integration]") {
@@ -38,11 +42,13 @@ TEST_CASE("Algorithm - Unit Propagation (2 propagation)", "[integration]") {
   sat::FactorGraph* graph = new sat::FactorGraph(file);
   file.close();
 
-  sat::utils::RandomGen::setSeed(7357);
+  sat::Solver solver(graph->variables.size(), 1.0, 7357);
+
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  bool result = sat::UnitPropagation(graph);
+  CHECK(result == sat::SAT);
 
-  CHECK(result);
+  delete graph;
 };
 
 TEST_CASE("Algorithm - Unit Propagation (2 unit clauses)", "[integration]") {
@@ -51,27 +57,28 @@ TEST_CASE("Algorithm - Unit Propagation (2 unit clauses)", "[integration]") {
   sat::FactorGraph* graph = new sat::FactorGraph(file);
   file.close();
 
-  sat::utils::RandomGen::setSeed(7357);
+  sat::Solver solver(graph->variables.size(), 1.0, 7357);
 
-  bool result = sat::UnitPropagation(graph);
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  CHECK(result);
+  CHECK(result == sat::SAT);
+
+  delete graph;
 };
 
 TEST_CASE("Algorithm - Unit Propagation (contradiction 1)", "[integration]") {
-  std::ifstream file("./test/cnf/2.cnf");
-  if (!file.is_open()) FAIL("ERROR: Can't open file ./test/cnf/2.cnf");
-  sat::FactorGraph* graph = new sat::FactorGraph(file);
-  file.close();
+  // Formula of 2.cnf forcing variable contradiction with (¬X1)
+  std::istringstream dimacs("p cnf 3 4\n1 0\n-1 -2 -3 0\n1 2 3 0\n-1 0\n");
+  sat::FactorGraph* graph = new sat::FactorGraph(dimacs);
 
-  sat::utils::RandomGen::setSeed(7357);
+  sat::Solver solver(graph->variables.size(), 1.0, 7357);
 
-  // Forcing variable contradiction
-  graph->GetUnassignedVariables()[0]->AssignValue(false);
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  bool result = sat::UnitPropagation(graph);
+  REQUIRE(result != sat::SAT);
+  CHECK_FALSE(graph->IsSAT());
 
-  REQUIRE_FALSE(result);
+  delete graph;
 };
 
 TEST_CASE("Algorithm - Unit Propagation (contradiction 2)", "[integration]") {
@@ -80,9 +87,11 @@ TEST_CASE("Algorithm - Unit Propagation (contradiction 2)", "[integration]") {
   sat::FactorGraph* graph = new sat::FactorGraph(file);
   file.close();
 
-  sat::utils::RandomGen::setSeed(7357);
+  sat::Solver solver(graph->variables.size(), 1.0, 7357);
 
-  bool result = sat::UnitPropagation(graph);
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  REQUIRE_FALSE(result);
-};
\ No newline at end of file
+  REQUIRE(result == sat::CONTRADICTION);
+
+  delete graph;
+};
@@ -2,9 +2,8 @@
 #include <iostream>
 
 // Project headders
-#include <Algorithms.hpp>
 #include <FactorGraph.hpp>
-#include <Utils.hpp>
+#include <Solver.hpp>
 
 TEST_CASE("Algorithm - Walksat (solution found)", "[integration]") {
   std::ifstream file("./test/cnf/6.cnf");
@@ -12,14 +11,18 @@ TEST_CASE("Algorithm - Walksat (solution found)", "[integration]") {
   sat::FactorGraph* graph = new sat::FactorGraph(file);
   file.close();
 
-  sat::utils::RandomGen::setSeed(7357);
+  // The paramagnetic state is reached at once, so SID calls walksat
+  sat::Solver solver(3, 7.0 / 3, 7357);
+  solver.paramagneticState = 1.0;
 
-  bool result = sat::Walksat(graph);
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  REQUIRE(result);
-  for (sat::Variable* var : graph->GetAllVariables()) {
+  REQUIRE(result == sat::SAT);
+  for (sat::Variable* var : graph->variables) {
     CHECK(var->value);
   }
+
+  delete graph;
 };
 
 TEST_CASE("Algorithm - Walksat (solution NOT found)", "[integration]") {
@@ -28,9 +31,13 @@ TEST_CASE("Algorithm - Walksat (solution NOT found)", "[integration]") {
   sat::FactorGraph* graph = new sat::FactorGraph(file);
   file.close();
 
-  sat::utils::RandomGen::setSeed(7357);
+  sat::Solver solver(3, 8.0 / 3, 7357);
+  solver.paramagneticState = 1.0;
+
+  sat::AlgorithmResult result = solver.SID(graph, 0.0);
 
-  bool result = sat::Walksat(graph);
+  REQUIRE(result != sat::SAT);
+  CHECK_FALSE(graph->IsSAT());
 
-  REQUIRE_FALSE(result);
+  delete graph;
 };
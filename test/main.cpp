@@ -1,4 +1,7 @@
 // This definition will create a main function that will run the tests
 #define CATCH_CONFIG_MAIN
+// The signal handlers of this Catch2 version need a constant MINSIGSTKSZ,
+// which newer glibc versions no longer define
+#define CATCH_CONFIG_NO_POSIX_SIGNALS
 
 #include <catch2/catch.hpp>
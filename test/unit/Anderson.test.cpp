@@ -0,0 +1,69 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <vector>
+
+// Project headders
+#include <Anderson.hpp>
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+// Iterations of x = G(x) until |G(x) - x| < 1e-10, with a linear contraction
+// G(x) = A x + b that converges slowly
+static int fixedPointIterations(unsigned depth, std::vector<double>& x) {
+  sat::AndersonAcceleration anderson(x.size(), depth, -10.0, 10.0);
+  std::vector<double> g(x.size()), next;
+  for (int it = 1; it <= 10000; it++) {
+    double diff = 0.0;
+    for (unsigned i = 0; i < x.size(); i++) {
+      double neighbour = x[(i + 1) % x.size()];
+      g[i] = 0.9 * x[i] + 0.05 * neighbour + 0.1 * (i % 3);
+      diff = std::max(diff, std::abs(g[i] - x[i]));
+    }
+    if (diff < 1e-10) return it;
+    if (anderson.Extrapolate(x, g, next))
+      x = next;
+    else
+      x = g;
+  }
+  return -1;
+}
+
+TEST_CASE("Anderson - Faster fixed point", "[unit]") {
+  std::vector<double> plain(50, 0.0), accelerated(50, 0.0);
+  int plainIterations = fixedPointIterations(0, plain);
+  int acceleratedIterations = fixedPointIterations(3, accelerated);
+
+  REQUIRE(plainIterations > 0);
+  REQUIRE(acceleratedIterations > 0);
+  CHECK(acceleratedIterations < plainIterations / 2);
+  for (unsigned i = 0; i < plain.size(); i++) {
+    CHECK(accelerated[i] == Approx(plain[i]).margin(1e-8));
+  }
+};
+
+TEST_CASE("Anderson - Extrapolation within bounds", "[unit]") {
+  sat::AndersonAcceleration anderson(2, 2);
+  std::vector<double> next;
+  CHECK_FALSE(anderson.Extrapolate({0.0, 0.0}, {0.5, 0.5}, next));
+  REQUIRE(anderson.Extrapolate({0.5, 0.5}, {0.9, 0.9}, next));
+  for (double value : next) {
+    CHECK(value >= 0.0);
+    CHECK(value <= 1.0);
+  }
+
+  anderson.Restart();
+  CHECK_FALSE(anderson.Extrapolate({0.0, 0.0}, {0.5, 0.5}, next));
+};
+
+TEST_CASE("Solver - SID with Anderson acceleration", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(2000, 8000);
+
+  sat::Solver solver(2000, 4.0, 7357);
+  solver.spAndersonDepth = 3;
+  REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+  REQUIRE(graph->IsSAT());
+  CHECK(solver.totalSPExtrapolations > 0);
+  delete graph;
+};
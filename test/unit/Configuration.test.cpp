@@ -0,0 +1,58 @@
+#include <catch2/catch.hpp>
+#include <type_traits>
+#include <vector>
+
+// Project headders
+#include <Configuration.hpp>
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("Configuration - Policies of the build", "[unit]") {
+  typedef sat::SolverConfiguration<float, sat::LogSubProducts, false> Custom;
+  CHECK(std::is_same<Custom::Survey, float>::value);
+  CHECK(std::is_same<Custom::SubProducts, sat::LogSubProducts>::value);
+  CHECK_FALSE(Custom::instrumentation);
+
+  CHECK(std::is_same<sat::Survey, sat::Configuration::Survey>::value);
+  CHECK(std::is_same<sat::SubProducts,
+                     sat::Configuration::SubProducts>::value);
+};
+
+// Planted 3-SAT formula, with an extra clause of 4 new variables if mixed
+static sat::FactorGraph* plantedFormula(bool mixed) {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(1000, 4000);
+
+  std::vector<unsigned> variableIds;
+  std::vector<int> literals;
+  for (sat::Clause* clause : graph->clauses) {
+    for (sat::Edge* edge : clause->allNeighbourEdges) {
+      int id = edge->variable->id;
+      literals.push_back(edge->type ? id : -id);
+    }
+    literals.push_back(0);
+  }
+  unsigned totalVariables = mixed ? 1004 : 1000;
+  if (mixed) literals.insert(literals.end(), {1001, -1002, 1003, -1004, 0});
+  for (unsigned id = 1; id <= totalVariables; id++) variableIds.push_back(id);
+  delete graph;
+  return new sat::FactorGraph(variableIds, literals);
+}
+
+TEST_CASE("Configuration - SID with every sweep policy", "[unit]") {
+  for (int mixed = 0; mixed < 2; mixed++) {
+    for (int damped = 0; damped < 2; damped++) {
+      for (int tracked = 0; tracked < 2; tracked++) {
+        sat::FactorGraph* graph = plantedFormula(mixed);
+        sat::Solver solver(graph->variables.size(), 4.0, 7357);
+        solver.spDamping = damped ? 0.3 : 0.0;
+        solver.spParamagneticCheck = tracked;
+
+        CHECK(solver.SID(graph, 0.01) == sat::SAT);
+        CHECK(graph->IsSAT());
+        delete graph;
+      }
+    }
+  }
+};
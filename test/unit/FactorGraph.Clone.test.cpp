@@ -0,0 +1,73 @@
+#include <catch2/catch.hpp>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("FactorGraph - Clone has the same structure and state", "[unit]") {
+  sat::FactorGraph* graph = sat::test::RandomGraph(500, 2100, sat::ORDER_RCM);
+
+  // Some state to copy
+  graph->variables[3]->AssignValue(true);
+  graph->clauses[5]->Dissable();
+  graph->edges[7]->survey = 0.25;
+  graph->variables[9]->p = 0.5;
+
+  sat::FactorGraph* clone = graph->Clone();
+  REQUIRE(clone->variables.size() == graph->variables.size());
+  REQUIRE(clone->clauses.size() == graph->clauses.size());
+  REQUIRE(clone->edges.size() == graph->edges.size());
+
+  for (unsigned i = 0; i < graph->variables.size(); i++) {
+    sat::Variable* var = graph->variables[i];
+    sat::Variable* cloneVar = clone->variables[i];
+    CHECK(cloneVar != var);
+    CHECK(cloneVar->id == var->id);
+    CHECK(cloneVar->assigned == var->assigned);
+    CHECK(cloneVar->p == var->p);
+    REQUIRE(cloneVar->allNeighbourEdges.size() ==
+            var->allNeighbourEdges.size());
+    for (sat::Edge* edge : cloneVar->allNeighbourEdges)
+      CHECK(edge->variable == cloneVar);
+  }
+  for (unsigned i = 0; i < graph->clauses.size(); i++) {
+    sat::Clause* clause = graph->clauses[i];
+    sat::Clause* cloneClause = clone->clauses[i];
+    CHECK(cloneClause->id == clause->id);
+    CHECK(cloneClause->enabled == clause->enabled);
+    REQUIRE(cloneClause->allNeighbourEdges.size() ==
+            clause->allNeighbourEdges.size());
+    for (unsigned k = 0; k < clause->allNeighbourEdges.size(); k++) {
+      sat::Edge* edge = clause->allNeighbourEdges[k];
+      sat::Edge* cloneEdge = cloneClause->allNeighbourEdges[k];
+      CHECK(cloneEdge->clause == cloneClause);
+      CHECK(cloneEdge->type == edge->type);
+      CHECK(cloneEdge->enabled == edge->enabled);
+      CHECK(cloneEdge->survey == edge->survey);
+      CHECK(cloneEdge->variable->id == edge->variable->id);
+    }
+  }
+  delete clone;
+  delete graph;
+};
+
+TEST_CASE("FactorGraph - Clones are solved independently", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(1000, 4000);
+  sat::FactorGraph* clone = graph->Clone();
+
+  // The same SID on the graph and the clone
+  sat::Solver solver(1000, 4.0, 7357);
+  REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+  int spIterations = solver.totalSPIterations;
+  for (sat::Variable* var : clone->variables) CHECK_FALSE(var->assigned);
+
+  // The clone keeps the shared lists when the graph is deleted
+  delete graph;
+  solver.setSeed(7357);
+  REQUIRE(solver.SID(clone, 0.01) == sat::SAT);
+  CHECK(clone->IsSAT());
+  CHECK(solver.totalSPIterations == spIterations);
+  delete clone;
+};
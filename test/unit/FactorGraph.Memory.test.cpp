@@ -0,0 +1,29 @@
+#include <catch2/catch.hpp>
+#include <iostream>
+#include <sstream>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Generator.hpp>
+#include <Memory.hpp>
+
+TEST_CASE("FactorGraph - Memory usage estimation", "[unit]") {
+  sat::Generator generator(7357);
+  std::stringstream dimacs;
+  generator.RandomKSAT(dimacs, 10000, 42000, 3);
+
+  sat::MemoryUsage estimation = sat::FactorGraph::EstimateMemoryUsage(dimacs);
+  dimacs.clear();
+  dimacs.seekg(0);
+  sat::FactorGraph graph(dimacs);
+  sat::MemoryUsage usage = graph.GetMemoryUsage();
+
+  // Variables, clauses and edges only depend on the header
+  CHECK(estimation.variables == usage.variables);
+  CHECK(estimation.clauses == usage.clauses);
+  CHECK(estimation.edges == usage.edges);
+
+  // Adjacency lists depend on the random occurrences of every variable
+  double error = (double)estimation.adjacency - usage.adjacency;
+  CHECK(std::abs(error) / usage.adjacency < 0.05);
+};
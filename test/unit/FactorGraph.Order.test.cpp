@@ -0,0 +1,77 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <iostream>
+#include <set>
+#include <utility>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Generator.hpp>
+#include <Solver.hpp>
+#include <Validator.hpp>
+
+#include "Helpers.hpp"
+
+// Literals of every clause by clause id
+static std::set<std::pair<unsigned, int>> clauseLiterals(
+    sat::FactorGraph& graph) {
+  std::set<std::pair<unsigned, int>> literals;
+  for (sat::Clause* clause : graph.clauses) {
+    for (sat::Edge* edge : clause->allNeighbourEdges) {
+      int variable = edge->variable->id;
+      literals.insert({clause->id, edge->type ? variable : -variable});
+    }
+  }
+  return literals;
+}
+
+TEST_CASE("FactorGraph - RCM order keeps the formula", "[unit]") {
+  // The same formula read in DIMACS and in RCM order
+  sat::FactorGraph* graph = sat::test::RandomGraph(1000, 4200);
+  sat::FactorGraph* reordered =
+      sat::test::RandomGraph(1000, 4200, sat::ORDER_RCM);
+
+  REQUIRE(reordered->variables.size() == graph->variables.size());
+  REQUIRE(reordered->clauses.size() == graph->clauses.size());
+  REQUIRE(reordered->edges.size() == graph->edges.size());
+  CHECK(clauseLiterals(*reordered) == clauseLiterals(*graph));
+
+  // Ids are a permutation of the DIMACS ids
+  std::set<unsigned> ids;
+  for (sat::Variable* var : reordered->variables) ids.insert(var->id);
+  CHECK(ids.size() == reordered->variables.size());
+  CHECK(*ids.begin() == 1);
+  CHECK(*ids.rbegin() == reordered->variables.size());
+
+  // Every edge is in the adjacency list of its variable
+  for (sat::Variable* var : reordered->variables) {
+    for (sat::Edge* edge : var->allNeighbourEdges) {
+      CHECK(edge->variable == var);
+    }
+  }
+  delete reordered;
+  delete graph;
+};
+
+TEST_CASE("FactorGraph - RCM order stores values in DIMACS order", "[unit]") {
+  sat::Generator generator(7357);
+  std::vector<bool> solution;
+  std::string path = "./test/cnf/planted-rcm.cnf";
+  {
+    std::ofstream file(path);
+    generator.PlantedKSAT(file, 500, 1500, 3, solution);
+  }
+
+  std::ifstream file(path);
+  sat::FactorGraph graph(file, sat::ORDER_RCM);
+  sat::Solver solver(500, 3.0, 7357);
+  REQUIRE(solver.SID(&graph, 0.01) == sat::SAT);
+
+  std::string solutionPath = path + ".sol";
+  graph.storeVariableValues(solutionPath);
+  Validator validator;
+  CHECK(validator.validateResult(path, solutionPath));
+
+  std::remove(path.c_str());
+  std::remove(solutionPath.c_str());
+};
@@ -0,0 +1,39 @@
+#include <catch2/catch.hpp>
+#include <iostream>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+TEST_CASE("FactorGraph - Reset", "[unit]") {
+  std::ifstream file("./test/cnf/1.cnf");
+  if (!file.is_open()) FAIL("ERROR: Can't open file ./test/cnf/1.cnf");
+  sat::FactorGraph* graph = new sat::FactorGraph(file);
+  file.close();
+
+  // Modify the graph as the solver would do
+  sat::Solver solver(graph->variables.size(), 1.0, 7357);
+  solver.SID(graph, 0.5);
+  graph->variables[0]->AssignValue(true);
+  graph->clauses[0]->Dissable();
+
+  graph->Reset();
+
+  for (sat::Variable* var : graph->variables) {
+    CHECK_FALSE(var->assigned);
+    CHECK(var->p == 1.0);
+    CHECK(var->m == 1.0);
+    CHECK(var->pzero == 0);
+    CHECK(var->mzero == 0);
+  }
+  for (sat::Clause* clause : graph->clauses) {
+    CHECK(clause->enabled);
+    CHECK(clause->trueLiterals == 0);
+  }
+  for (sat::Edge* edge : graph->edges) {
+    CHECK(edge->enabled);
+    CHECK(edge->survey == 0.0);
+  }
+
+  delete graph;
+};
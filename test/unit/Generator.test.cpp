@@ -0,0 +1,40 @@
+#include <catch2/catch.hpp>
+#include <iostream>
+#include <sstream>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Generator.hpp>
+
+TEST_CASE("Generator - Random k-SAT", "[unit]") {
+  sat::Generator generator(7357);
+  std::stringstream dimacs;
+  generator.RandomKSAT(dimacs, 100, 420, 3);
+
+  sat::FactorGraph graph(dimacs);
+  REQUIRE(graph.variables.size() == 100);
+  REQUIRE(graph.clauses.size() == 420);
+  REQUIRE(graph.edges.size() == 420 * 3);
+
+  // Variables of a clause are all different
+  for (sat::Clause* clause : graph.clauses) {
+    const sat::EdgeList& edges = clause->allNeighbourEdges;
+    CHECK(edges[0]->variable != edges[1]->variable);
+    CHECK(edges[0]->variable != edges[2]->variable);
+    CHECK(edges[1]->variable != edges[2]->variable);
+  }
+};
+
+TEST_CASE("Generator - Planted k-SAT", "[unit]") {
+  sat::Generator generator(7357);
+  std::stringstream dimacs;
+  std::vector<bool> solution;
+  generator.PlantedKSAT(dimacs, 100, 500, 3, solution);
+
+  sat::FactorGraph graph(dimacs);
+  for (sat::Variable* var : graph.variables) {
+    var->AssignValue(solution[var->id - 1]);
+  }
+
+  REQUIRE(graph.IsSAT());
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <sstream>
+#include <vector>
+
+// Project headers
+#include <FactorGraph.hpp>
+#include <Generator.hpp>
+
+namespace sat {
+namespace test {
+
+// -----------------------------------------------------------------------------
+// PlantedGraph / RandomGraph
+//
+// Planted or random 3-SAT formula with N variables and M clauses, generated
+// with the seed of the tests. The caller owns the graph
+// -----------------------------------------------------------------------------
+inline FactorGraph* PlantedGraph(int N, int M, std::vector<bool>& solution,
+                                 GraphOrder order = ORDER_DIMACS) {
+  Generator generator(7357);
+  std::stringstream dimacs;
+  generator.PlantedKSAT(dimacs, N, M, 3, solution);
+  return new FactorGraph(dimacs, order);
+}
+
+inline FactorGraph* PlantedGraph(int N, int M,
+                                 GraphOrder order = ORDER_DIMACS) {
+  std::vector<bool> solution;
+  return PlantedGraph(N, M, solution, order);
+}
+
+inline FactorGraph* RandomGraph(int N, int M, GraphOrder order = ORDER_DIMACS) {
+  Generator generator(7357);
+  std::stringstream dimacs;
+  generator.RandomKSAT(dimacs, N, M, 3);
+  return new FactorGraph(dimacs, order);
+}
+
+}  // namespace test
+}  // namespace sat
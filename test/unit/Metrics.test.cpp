@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+#include <iostream>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Metrics.hpp>
+#include <Solver.hpp>
+
+TEST_CASE("Metrics - Disabled", "[unit]") {
+  sat::Metrics metrics;
+  {
+    sat::PhaseTimer timer(metrics, sat::PHASE_UP);
+  }
+
+  CHECK(metrics.calls[sat::PHASE_UP] == 0);
+  CHECK(metrics.nanoseconds[sat::PHASE_UP] == 0);
+};
+
+TEST_CASE("Metrics - Nested phases", "[unit]") {
+  sat::Metrics metrics;
+  metrics.enabled = true;
+  {
+    sat::PhaseTimer outer(metrics, sat::PHASE_UP);
+    sat::PhaseTimer inner(metrics, sat::PHASE_UP);
+    CHECK(metrics.depth[sat::PHASE_UP] == 2);
+  }
+
+  CHECK(metrics.calls[sat::PHASE_UP] == 2);
+  CHECK(metrics.depth[sat::PHASE_UP] == 0);
+};
+
+TEST_CASE("Metrics - SID", "[unit]") {
+  std::ifstream file("./test/cnf/1.cnf");
+  if (!file.is_open()) FAIL("ERROR: Can't open file ./test/cnf/1.cnf");
+  sat::FactorGraph* graph = new sat::FactorGraph(file);
+  file.close();
+
+  sat::Solver solver(graph->variables.size(), 1.0, 7357);
+  solver.metrics.enabled = true;
+  solver.SID(graph, 0.1);
+
+  CHECK(solver.metrics.calls[sat::PHASE_SP_SWEEP] ==
+        (uint64_t)solver.totalSPIterations);
+  CHECK(solver.metrics.calls[sat::PHASE_SUBPRODUCTS] ==
+        (uint64_t)solver.totalSIDIterations);
+
+  delete graph;
+};
@@ -0,0 +1,72 @@
+#include <catch2/catch.hpp>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Portfolio.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+static void noOptions(sat::Solver&) {}
+
+TEST_CASE("Portfolio - The winner's model is assigned to the graph",
+          "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(1000, 4000, sat::ORDER_RCM);
+
+  sat::Portfolio portfolio;
+  portfolio.threads = 2;
+  portfolio.Add(0.04, sat::SCHEDULE_FIXED, sat::SWEEP_SHUFFLE);
+  portfolio.Add(0.01, sat::SCHEDULE_ADAPTIVE, sat::SWEEP_RANDOM_OFFSET);
+  portfolio.Add(0.02, sat::SCHEDULE_FIXED, sat::SWEEP_BLOCK_SHUFFLE);
+
+  REQUIRE(portfolio.Solve(graph, 7357, 1, noOptions) == sat::SAT);
+  CHECK(graph->IsSAT());
+  REQUIRE(portfolio.winner >= 0);
+  CHECK(portfolio.members[portfolio.winner].started);
+  CHECK(portfolio.members[portfolio.winner].result == sat::SAT);
+  CHECK_FALSE(portfolio.expired);
+  delete graph;
+};
+
+TEST_CASE("Portfolio - The first member is the single solver", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(1000, 4000);
+
+  sat::Solver solver(1000, 4.0, 7357);
+  solver.setSeed(7357, 3);
+  solver.wsMaxTries = 2;
+  sat::AlgorithmResult result = solver.SID(graph, 0.02);
+  graph->Reset();
+
+  // One worker: the members after a solution are not started
+  sat::Portfolio portfolio;
+  for (int m = 0; m < 4; m++)
+    portfolio.Add(0.02, sat::SCHEDULE_FIXED, sat::SWEEP_SHUFFLE);
+  portfolio.Solve(graph, 7357, 3,
+                  [](sat::Solver& member) { member.wsMaxTries = 2; });
+  CHECK(portfolio.members[0].result == result);
+  CHECK(portfolio.members[0].spIterations == solver.totalSPIterations);
+  CHECK(portfolio.members[0].sidIterations == solver.totalSIDIterations);
+  for (int m = portfolio.winner + 1; m < 4; m++) {
+    if (portfolio.members[portfolio.winner].result == sat::SAT)
+      CHECK_FALSE(portfolio.members[m].started);
+  }
+  delete graph;
+};
+
+TEST_CASE("Portfolio - Stop all the members when the budget is over",
+          "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(20000, 84000);
+
+  sat::Portfolio portfolio;
+  portfolio.threads = 2;
+  portfolio.budget = 0.05;
+  for (int m = 0; m < 4; m++)
+    portfolio.Add(0.0025, sat::SCHEDULE_FIXED, sat::SWEEP_SHUFFLE);
+  sat::AlgorithmResult result = portfolio.Solve(
+      graph, 7357, 1, [](sat::Solver& member) { member.spEpsilon = 1e-9; });
+
+  CHECK(result != sat::SAT);
+  CHECK(portfolio.expired);
+  CHECK(portfolio.seconds < 5.0);
+  delete graph;
+};
@@ -0,0 +1,170 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Generator.hpp>
+#include <Preprocessor.hpp>
+#include <Solver.hpp>
+#include <Validator.hpp>
+
+TEST_CASE("Preprocessor - Simplifications", "[unit]") {
+  std::stringstream dimacs;
+  dimacs << "p cnf 7 8\n";
+  dimacs << "1 1 2 0\n";    // Duplicate literal
+  dimacs << "3 -3 4 0\n";   // Tautology
+  dimacs << "-2 0\n";       // Unit: 1 becomes unit too
+  dimacs << "-1 5 6 0\n";   // 5 6 after UP
+  dimacs << "6 5 0\n";      // Duplicate of the previous one after UP
+  dimacs << "-5 -6 7 0\n";  // 7 is pure
+  dimacs << "-5 6 0\n";
+  dimacs << "5 -6 0\n";
+  sat::FactorGraph graph(dimacs);
+
+  sat::Preprocessor preprocessor(graph);
+  REQUIRE(preprocessor.Run());
+  CHECK(preprocessor.duplicateLiterals == 1);
+  CHECK(preprocessor.tautologies == 1);
+  CHECK(preprocessor.unitLiterals == 2);
+  CHECK(preprocessor.pureLiterals == 1);
+  CHECK(preprocessor.duplicateClauses == 1);
+
+  // Remaining clauses only contain 5 and 6
+  CHECK(preprocessor.GetRemainingClauses() == 3);
+  CHECK(preprocessor.GetRemainingVariables() == 2);
+  sat::FactorGraph* reduced = preprocessor.BuildGraph();
+  for (sat::Variable* var : reduced->variables) {
+    CHECK((var->id == 5 || var->id == 6));
+  }
+
+  // Any model of the reduced graph extends to a model of the formula
+  for (sat::Variable* var : reduced->variables) var->AssignValue(true);
+  REQUIRE(reduced->IsSAT());
+  std::vector<bool> model = preprocessor.ExtendModel(*reduced);
+  REQUIRE(model.size() == 7);
+  for (sat::Variable* var : graph.variables) {
+    var->AssignValue(model[var->id - 1]);
+  }
+  CHECK(graph.IsSAT());
+
+  delete reduced;
+};
+
+TEST_CASE("Preprocessor - Conflict", "[unit]") {
+  std::stringstream dimacs;
+  dimacs << "p cnf 2 3\n";
+  dimacs << "1 0\n";
+  dimacs << "-1 2 0\n";
+  dimacs << "-2 0\n";
+  sat::FactorGraph graph(dimacs);
+
+  sat::Preprocessor preprocessor(graph);
+  CHECK_FALSE(preprocessor.Run());
+};
+
+TEST_CASE("Preprocessor - SID over the simplified graph", "[unit]") {
+  sat::Generator generator(7357);
+  std::vector<bool> solution;
+  std::string path = "./test/cnf/planted-preprocess.cnf";
+  {
+    std::ofstream file(path);
+    generator.PlantedKSAT(file, 500, 1500, 3, solution);
+  }
+
+  std::ifstream file(path);
+  sat::FactorGraph graph(file);
+  sat::Preprocessor preprocessor(graph);
+  REQUIRE(preprocessor.Run());
+  CHECK(preprocessor.pureLiterals > 0);
+  CHECK(preprocessor.GetRemainingClauses() < 1500);
+
+  sat::FactorGraph* reduced = preprocessor.BuildGraph(sat::ORDER_RCM);
+  sat::Solver solver(500, 3.0, 7357);
+  REQUIRE(solver.SID(reduced, 0.01) == sat::SAT);
+
+  std::string solutionPath = path + ".sol";
+  preprocessor.storeModel(*reduced, solutionPath);
+  Validator validator;
+  CHECK(validator.validateResult(path, solutionPath));
+
+  delete reduced;
+  std::remove(path.c_str());
+  std::remove(solutionPath.c_str());
+};
+
+// Brute force check of the satisfiability of a small formula
+static bool bruteForceSAT(sat::FactorGraph& graph) {
+  unsigned total = graph.variables.size();
+  for (unsigned mask = 0; mask < (1u << total); mask++) {
+    for (unsigned v = 0; v < total; v++) {
+      graph.variables[v]->AssignValue(mask & (1u << v));
+    }
+    if (graph.IsSAT()) return true;
+  }
+  return false;
+}
+
+TEST_CASE("Preprocessor - Variable elimination", "[unit]") {
+  // Small random formulas around the threshold, SAT and UNSAT
+  for (unsigned seed = 1; seed <= 40; seed++) {
+    sat::Generator generator(seed);
+    std::stringstream dimacs;
+    generator.RandomKSAT(dimacs, 14, 60, 3);
+    sat::FactorGraph graph(dimacs);
+    bool satisfiable = bruteForceSAT(graph);
+
+    sat::Preprocessor preprocessor(graph);
+    preprocessor.variableElimination = true;
+    bool consistent = preprocessor.Run();
+    if (!consistent) {
+      CHECK_FALSE(satisfiable);
+      continue;
+    }
+
+    sat::FactorGraph* reduced = preprocessor.BuildGraph();
+    CHECK(bruteForceSAT(*reduced) == satisfiable);
+
+    // The model found for the reduced graph satisfies the original formula
+    if (satisfiable) {
+      std::vector<bool> model = preprocessor.ExtendModel(*reduced);
+      for (sat::Variable* var : graph.variables) {
+        var->AssignValue(model[var->id - 1]);
+      }
+      CHECK(graph.IsSAT());
+    }
+    delete reduced;
+  }
+};
+
+TEST_CASE("Preprocessor - SID after variable elimination", "[unit]") {
+  sat::Generator generator(7357);
+  std::vector<bool> solution;
+  std::string path = "./test/cnf/planted-bve.cnf";
+  {
+    std::ofstream file(path);
+    generator.PlantedKSAT(file, 1000, 3000, 3, solution);
+  }
+
+  std::ifstream file(path);
+  sat::FactorGraph graph(file);
+  sat::Preprocessor preprocessor(graph);
+  preprocessor.variableElimination = true;
+  REQUIRE(preprocessor.Run());
+  CHECK(preprocessor.eliminatedVariables > 0);
+  CHECK(preprocessor.GetRemainingClauses() <= 3000);
+
+  sat::FactorGraph* reduced = preprocessor.BuildGraph();
+  sat::Solver solver(1000, 3.0, 7357);
+  REQUIRE(solver.SID(reduced, 0.01) == sat::SAT);
+
+  std::string solutionPath = path + ".sol";
+  preprocessor.storeModel(*reduced, solutionPath);
+  Validator validator;
+  CHECK(validator.validateResult(path, solutionPath));
+
+  delete reduced;
+  std::remove(path.c_str());
+  std::remove(solutionPath.c_str());
+};
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// Project headders
+#include <Random.hpp>
+
+TEST_CASE("Random - Philox4x32 known answers", "[unit]") {
+  // Known answer tests of Random123 for philox4x32_10
+  uint32_t out[4];
+
+  uint32_t zeroCounter[4] = {0, 0, 0, 0};
+  uint32_t zeroKey[2] = {0, 0};
+  sat::Philox4x32::Block(zeroCounter, zeroKey, out);
+  CHECK(out[0] == 0x6627e8d5);
+  CHECK(out[1] == 0xe169c58d);
+  CHECK(out[2] == 0xbc57ac4c);
+  CHECK(out[3] == 0x9b00dbd8);
+
+  uint32_t onesCounter[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+  uint32_t onesKey[2] = {0xffffffff, 0xffffffff};
+  sat::Philox4x32::Block(onesCounter, onesKey, out);
+  CHECK(out[0] == 0x408f276d);
+  CHECK(out[1] == 0x41c83b0e);
+  CHECK(out[2] == 0xa20bc7c6);
+  CHECK(out[3] == 0x6d5451fd);
+};
+
+TEST_CASE("Random - Xoshiro256PlusPlus", "[unit]") {
+  sat::Xoshiro256PlusPlus engine;
+  engine.state[0] = 1;
+  engine.state[1] = 2;
+  engine.state[2] = 3;
+  engine.state[3] = 4;
+
+  CHECK(engine() == 41943041);
+};
+
+TEST_CASE("Random - Reproducible streams", "[unit]") {
+  sat::RandomEngine a(7357, 0);
+  sat::RandomEngine b(7357, 0);
+  sat::RandomEngine c(7357, 1);
+
+  int equalStreams = 0;
+  for (int i = 0; i < 100; i++) {
+    uint64_t x = a();
+    CHECK(x == b());
+    if (x == c()) equalStreams++;
+  }
+  CHECK(equalStreams == 0);
+};
+
+TEST_CASE("Random - Bounded integers and reals", "[unit]") {
+  sat::RandomEngine engine(7357);
+
+  std::vector<int> histogram(7, 0);
+  for (int i = 0; i < 70000; i++) {
+    uint32_t x = sat::RandomBelow(engine, 7);
+    REQUIRE(x < 7);
+    histogram[x]++;
+  }
+  for (int count : histogram) CHECK(std::abs(count - 10000) < 500);
+
+  for (int i = 0; i < 1000; i++) {
+    double x = sat::RandomReal01(engine);
+    REQUIRE(x >= 0.0);
+    REQUIRE(x < 1.0);
+  }
+};
+
+TEST_CASE("Random - Shuffle", "[unit]") {
+  sat::RandomEngine engine(7357);
+  std::vector<int> values(100);
+  for (int i = 0; i < 100; i++) values[i] = i;
+
+  std::vector<int> shuffled = values;
+  sat::Shuffle(shuffled.begin(), shuffled.end(), engine);
+  CHECK(shuffled != values);
+
+  std::sort(shuffled.begin(), shuffled.end());
+  CHECK(shuffled == values);
+};
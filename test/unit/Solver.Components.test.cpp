@@ -0,0 +1,151 @@
+#include <catch2/catch.hpp>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Generator.hpp>
+#include <Solver.hpp>
+
+// Formula with two planted 3-SAT parts of n variables and some small clauses
+// over their own variables, so it has at least 2 big components
+static sat::FactorGraph* disjointFormula(unsigned n) {
+  sat::Generator generator(7357);
+  std::vector<unsigned> variableIds;
+  std::vector<int> literals;
+
+  for (int part = 0; part < 2; part++) {
+    std::stringstream dimacs;
+    std::vector<bool> solution;
+    generator.PlantedKSAT(dimacs, n, 4 * n, 3, solution);
+    sat::FactorGraph graph(dimacs);
+    int offset = part * n;
+    for (sat::Clause* clause : graph.clauses) {
+      for (sat::Edge* edge : clause->allNeighbourEdges) {
+        int index = offset + edge->variable->id;
+        literals.push_back(edge->type ? index : -index);
+      }
+      literals.push_back(0);
+    }
+  }
+
+  // Small components of 2 variables
+  for (int index = 2 * n + 1; index < (int)(2 * n + 20); index += 2) {
+    literals.insert(literals.end(), {index, -(index + 1), 0});
+  }
+
+  for (unsigned id = 1; id <= 2 * n + 20; id++) variableIds.push_back(id);
+  return new sat::FactorGraph(variableIds, literals);
+}
+
+TEST_CASE("Solver - SID by components", "[unit]") {
+  sat::FactorGraph* graph = disjointFormula(400);
+
+  sat::Solver solver(820, 4.0, 7357);
+  solver.components = true;
+  solver.threads = 2;
+  REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+  CHECK(graph->IsSAT());
+  // 2 big components and the group of the small ones
+  CHECK(solver.totalComponents >= 3);
+  CHECK(solver.totalSPIterations > 0);
+
+  delete graph;
+};
+
+TEST_CASE("Solver - Components don't depend on the threads", "[unit]") {
+  sat::FactorGraph* graph = disjointFormula(300);
+  std::vector<bool> values[2];
+
+  for (int t = 0; t < 2; t++) {
+    graph->Reset();
+    sat::Solver solver(620, 4.0, 7357);
+    solver.components = true;
+    solver.threads = t == 0 ? 1 : 4;
+    REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+    for (sat::Variable* var : graph->variables) values[t].push_back(var->value);
+  }
+  CHECK(values[0] == values[1]);
+
+  delete graph;
+};
+
+TEST_CASE("Solver - Components use the walksat options", "[unit]") {
+  sat::FactorGraph* graph = disjointFormula(400);
+
+  // Every component goes to walksat at once, with a few flips
+  sat::Solver solver(820, 4.0, 7357);
+  solver.components = true;
+  solver.paramagneticState = 1.0;
+  solver.wsMaxTries = 1;
+  solver.wsMaxFlips = 5;
+  solver.SID(graph, 0.01);
+  CHECK(solver.totalComponents >= 3);
+  CHECK(solver.totalWSFlips <= 5 * solver.totalComponents);
+
+  delete graph;
+};
+
+TEST_CASE("Solver - Components report progress and the best assignment",
+          "[unit]") {
+  sat::FactorGraph* graph = disjointFormula(400);
+
+  // Every component goes to walksat at once, and can't solve it
+  sat::Solver solver(820, 4.0, 7357);
+  solver.components = true;
+  solver.threads = 2;
+  solver.paramagneticState = 1.0;
+  solver.wsMaxTries = 1;
+  solver.wsMaxFlips = 200;
+  solver.progressFlips = 50;
+  solver.keepBestAssignment = true;
+
+  std::vector<int> flips(3, 0);
+  int calls = 0;
+  solver.progress = [&](const sat::SolverProgress& state) {
+    calls++;
+    if (state.component < 0 || state.unsatClauses < 0) return;
+    REQUIRE(state.component < 3);
+    CHECK(state.round >= 1);
+    CHECK(state.walksatFlips > flips[state.component]);
+    flips[state.component] = state.walksatFlips;
+  };
+
+  CHECK(solver.SID(graph, 0.01) == sat::INDETERMINATE);
+  REQUIRE(solver.totalComponents == 3);
+  CHECK(calls > 0);
+  // The big components use all their flips
+  CHECK(flips[0] == 200);
+  CHECK(flips[1] == 200);
+
+  // The best assignment merges the ones of the components
+  std::vector<int> literals;
+  int unsat = solver.GetBestAssignment(literals);
+  CHECK(unsat > 0);
+  CHECK(literals.size() >= 800);
+  graph->Reset();
+  for (int literal : literals)
+    graph->variables[std::abs(literal) - 1]->AssignValue(literal > 0);
+  int unsatClauses = 0;
+  for (sat::Clause* clause : graph->clauses) unsatClauses += !clause->IsSAT();
+  CHECK(unsatClauses == unsat);
+
+  delete graph;
+};
+
+TEST_CASE("Solver - Walksat on components denser than the formula",
+          "[unit]") {
+  // The ratio of the solver is far below the one of every component, so it
+  // doesn't bound the break count of the variables
+  sat::FactorGraph* graph = disjointFormula(400);
+
+  sat::Solver solver(820, 0.001, 7357);
+  solver.components = true;
+  solver.paramagneticState = 1.0;
+  REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+  CHECK(graph->IsSAT());
+  CHECK(solver.totalWSFlips > 0);
+
+  delete graph;
+};
@@ -0,0 +1,70 @@
+#include <catch2/catch.hpp>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Generator.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("Solver - SID with damped SP", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(2000, 8400);
+
+  sat::Solver solver(2000, 4.2, 7357);
+  solver.spDamping = 0.3;
+  REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+  REQUIRE(graph->IsSAT());
+  CHECK(solver.totalSPAborts == 0);
+  delete graph;
+};
+
+TEST_CASE("Solver - SP stalled above the threshold", "[unit]") {
+  // SP doesn't converge on random 3-SAT with a = 4.5
+  sat::FactorGraph* graph = sat::test::RandomGraph(2000, 9000);
+
+  sat::Solver solver(2000, 4.5, 7357);
+  solver.spStallWindow = 20;
+  REQUIRE(solver.SID(graph, 0.01) == sat::UNCONVERGE);
+
+  // Damping raised 4 times until spMaxDamping (0.8), then aborted before
+  // spMaxIt
+  CHECK(solver.totalSPStalls == 5);
+  CHECK(solver.totalSPAborts == 1);
+  CHECK(solver.totalSPIterations < solver.spMaxIt);
+  delete graph;
+};
+
+TEST_CASE("Solver - Components use damping and the stall detector",
+          "[unit]") {
+  // Two random 3-SAT parts with a = 4.5 over their own variables
+  sat::Generator generator(7357);
+  std::vector<unsigned> variableIds;
+  std::vector<int> literals;
+  for (int part = 0; part < 2; part++) {
+    std::stringstream dimacs;
+    generator.RandomKSAT(dimacs, 1000, 4500, 3);
+    sat::FactorGraph graph(dimacs);
+    for (sat::Clause* clause : graph.clauses) {
+      for (sat::Edge* edge : clause->allNeighbourEdges) {
+        int index = part * 1000 + edge->variable->id;
+        literals.push_back(edge->type ? index : -index);
+      }
+      literals.push_back(0);
+    }
+  }
+  for (unsigned id = 1; id <= 2000; id++) variableIds.push_back(id);
+  sat::FactorGraph graph(variableIds, literals);
+
+  sat::Solver solver(2000, 4.5, 7357);
+  solver.components = true;
+  solver.spStallWindow = 20;
+  REQUIRE(solver.SID(&graph, 0.01) == sat::UNCONVERGE);
+
+  // The component that doesn't converge is stalled and aborted
+  CHECK(solver.totalComponents >= 2);
+  CHECK(solver.totalSPStalls >= 5);
+  CHECK(solver.totalSPAborts >= 1);
+};
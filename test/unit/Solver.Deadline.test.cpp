@@ -0,0 +1,64 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <string>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("Solver - SID returns TIMEOUT after the deadline", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(1000, 4000);
+  sat::Solver solver(1000, 4.0, 7357);
+  solver.deadline = std::chrono::steady_clock::now();
+
+  CHECK(solver.SID(graph, 0.01) == sat::TIMEOUT);
+  CHECK(solver.totalSIDIterations == 0);
+  CHECK(std::string(sat::Solver::ResultName(sat::TIMEOUT)) == "TIMEOUT");
+
+  // Without a deadline the same solver solves it
+  solver.setTimeLimit(0);
+  graph->Reset();
+  CHECK(solver.SID(graph, 0.01) == sat::SAT);
+  delete graph;
+};
+
+TEST_CASE("Solver - The deadline stops SP and WalkSAT", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(20000, 84000);
+  sat::Solver solver(20000, 4.2, 7357);
+
+  // SP doesn't converge with this epsilon, so SID only stops at the deadline
+  solver.spEpsilon = 1e-12;
+  solver.spMaxIt = 1000000;
+  solver.setTimeLimit(0.05);
+  auto begin = std::chrono::steady_clock::now();
+  CHECK(solver.SID(graph, 0.01) == sat::TIMEOUT);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+  CHECK(elapsed.count() < 2.0);
+
+  // The paramagnetic state is reached after the first SP iteration, and
+  // WalkSAT can't solve it with a single flip per try before the deadline
+  graph->Reset();
+  solver.spParamagneticCheck = true;
+  solver.paramagneticState = 1.0;
+  solver.wsMaxTries = 1000000;
+  solver.wsMaxFlips = 1;
+  solver.setTimeLimit(0.2);
+  CHECK(solver.SID(graph, 0.01) == sat::TIMEOUT);
+  CHECK(solver.totalWSFlips > 0);
+  delete graph;
+};
+
+TEST_CASE("Solver - Cancelled SID returns INDETERMINATE", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(1000, 4000);
+  sat::Solver solver(1000, 4.0, 7357);
+  std::atomic<bool> stop(true);
+  solver.cancel = &stop;
+  solver.setTimeLimit(60);
+
+  CHECK(solver.SID(graph, 0.01) == sat::INDETERMINATE);
+  delete graph;
+};
@@ -0,0 +1,71 @@
+#include <catch2/catch.hpp>
+#include <iostream>
+#include <vector>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("Solver - Parallel decimation doesn't depend on the threads",
+          "[unit]") {
+  // More variables than one block of the bias evaluation
+  sat::FactorGraph* graph = sat::test::PlantedGraph(10000, 35000);
+  std::vector<bool> values[2];
+  int spIterations[2];
+
+  for (int t = 0; t < 2; t++) {
+    graph->Reset();
+    sat::Solver solver(10000, 3.5, 7357);
+    solver.threads = t == 0 ? 1 : 3;
+    REQUIRE(solver.SID(graph, 0.02) == sat::SAT);
+    REQUIRE(graph->IsSAT());
+    for (sat::Variable* var : graph->variables) values[t].push_back(var->value);
+    spIterations[t] = solver.totalSPIterations;
+  }
+  CHECK(values[0] == values[1]);
+  CHECK(spIterations[0] == spIterations[1]);
+  delete graph;
+};
+
+TEST_CASE("Solver - Decimation fixes the whole fraction after UP", "[unit]") {
+  // Planted 3-SAT with chains of implications between the literals of the
+  // solution, so fixing a variable assigns many others by UP
+  std::vector<bool> solution;
+  sat::FactorGraph* planted = sat::test::PlantedGraph(1000, 3000, solution);
+  std::vector<unsigned> variableIds;
+  std::vector<int> literals;
+  for (sat::Clause* clause : planted->clauses) {
+    for (sat::Edge* edge : clause->allNeighbourEdges) {
+      int id = edge->variable->id;
+      literals.push_back(edge->type ? id : -id);
+    }
+    literals.push_back(0);
+  }
+  for (int id = 1; id <= 1000; id++) {
+    variableIds.push_back(id);
+    // Chains of 4 variables
+    if (id % 4 == 0) continue;
+    int from = solution[id - 1] ? id : -id;
+    int to = solution[id] ? id + 1 : -(id + 1);
+    literals.insert(literals.end(), {-from, to, 0});
+  }
+  sat::FactorGraph graph(variableIds, literals);
+
+  // Variables fixed by the decimation in every round
+  sat::Solver solver(1000, 4.4, 7357);
+  solver.paramagneticState = 0.0;
+  std::vector<int> assignments;
+  solver.progress = [&](const sat::SolverProgress& state) {
+    if (state.unsatClauses < 0) assignments.push_back(solver.totalAssignments);
+  };
+  sat::AlgorithmResult result = solver.SID(&graph, 0.04);
+  REQUIRE(result != sat::UNCONVERGE);
+  REQUIRE(assignments.size() > 2);
+
+  // Every round but the last one fixes 40 variables
+  for (unsigned r = 1; r < assignments.size(); r++)
+    CHECK(assignments[r] - assignments[r - 1] == 40);
+  delete planted;
+};
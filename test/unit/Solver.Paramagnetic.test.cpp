@@ -0,0 +1,31 @@
+#include <catch2/catch.hpp>
+#include <iostream>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("Solver - Paramagnetic state checked in SP", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(2000, 6000);
+  int spIterations[2];
+
+  for (int check = 0; check < 2; check++) {
+    graph->Reset();
+    sat::Solver solver(2000, 3.0, 7357);
+    solver.spParamagneticCheck = check;
+    CHECK(solver.GetAverageMaxBias() == 0.0);
+    REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+    REQUIRE(graph->IsSAT());
+    spIterations[check] = solver.totalSPIterations;
+
+    // Solved by walksat once in paramagnetic state
+    CHECK(solver.totalWSFlips > 0);
+    CHECK(solver.GetAverageMaxBias() < solver.paramagneticState);
+  }
+
+  // Walksat is called before SP converges
+  CHECK(spIterations[1] < spIterations[0]);
+  delete graph;
+};
@@ -0,0 +1,97 @@
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <vector>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("Solver - Progress is reported every SID round", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(1000, 4000);
+  sat::Solver solver(1000, 4.0, 7357);
+  std::vector<sat::SolverProgress> rounds;
+  solver.progress = [&](const sat::SolverProgress& state) {
+    if (state.unsatClauses < 0) rounds.push_back(state);
+  };
+
+  REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+  REQUIRE(rounds.size() == (unsigned)solver.totalSIDIterations);
+  CHECK(rounds[0].round == 1);
+  CHECK(rounds[0].unassignedVariables == 1000);
+  CHECK(rounds[0].enabledClauses == 4000);
+  CHECK(rounds[0].lastSPIterations == 0);
+  for (unsigned r = 1; r < rounds.size(); r++) {
+    CHECK(rounds[r].round == (int)r + 1);
+    CHECK(rounds[r].unassignedVariables < rounds[r - 1].unassignedVariables);
+    CHECK(rounds[r].enabledClauses <= rounds[r - 1].enabledClauses);
+    CHECK(rounds[r].lastSPIterations > 0);
+    CHECK(rounds[r].maxSurveyDiff <= solver.spEpsilon);
+  }
+  delete graph;
+};
+
+TEST_CASE("Solver - Progress and best assignment in WalkSAT", "[unit]") {
+  // The paramagnetic state is reached in the first round and WalkSAT can't
+  // solve the formula with these flips
+  sat::FactorGraph* graph = sat::test::PlantedGraph(2000, 8400);
+  sat::Solver solver(2000, 4.2, 7357);
+  solver.paramagneticState = 1.0;
+  solver.wsMaxTries = 3;
+  solver.wsMaxFlips = 2000;
+  solver.progressFlips = 500;
+  solver.keepBestAssignment = true;
+
+  int calls = 0;
+  int bestUnsat = -1;
+  solver.progress = [&](const sat::SolverProgress& state) {
+    if (state.unsatClauses < 0) {
+      // Before WalkSAT the best assignment is the partial one
+      std::vector<int> literals;
+      CHECK(solver.GetBestAssignment(literals) == 0);
+      CHECK(literals.size() == 2000 - state.unassignedVariables);
+      return;
+    }
+    calls++;
+    CHECK(state.walksatFlips == 500 * calls);
+    CHECK(state.unsatClauses > 0);
+
+    // The best assignment never gets worse
+    std::vector<int> literals;
+    int unsat = solver.GetBestAssignment(literals);
+    CHECK(unsat <= state.unsatClauses);
+    if (bestUnsat >= 0) CHECK(unsat <= bestUnsat);
+    bestUnsat = unsat;
+    CHECK(literals.size() == 2000);
+  };
+
+  CHECK(solver.SID(graph, 0.01) == sat::INDETERMINATE);
+  CHECK(calls == 12);
+
+  // The best assignment has the unsat clauses it reports
+  std::vector<int> literals;
+  int unsat = solver.GetBestAssignment(literals);
+  CHECK(unsat <= bestUnsat);
+  for (int literal : literals)
+    graph->variables[std::abs(literal) - 1]->AssignValue(literal > 0);
+  int unsatClauses = 0;
+  for (sat::Clause* clause : graph->clauses) unsatClauses += !clause->IsSAT();
+  CHECK(unsatClauses == unsat);
+  delete graph;
+};
+
+TEST_CASE("Solver - The progress callback can cancel SID", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(1000, 4000);
+  sat::Solver solver(1000, 4.0, 7357);
+  solver.paramagneticState = 0.0;
+  std::atomic<bool> stop(false);
+  solver.cancel = &stop;
+  solver.progress = [&](const sat::SolverProgress& state) {
+    if (state.round == 3) stop = true;
+  };
+
+  CHECK(solver.SID(graph, 0.01) == sat::INDETERMINATE);
+  CHECK(solver.totalSIDIterations == 3);
+  delete graph;
+};
@@ -0,0 +1,44 @@
+#include <catch2/catch.hpp>
+#include <iostream>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("Solver - Schedule names", "[unit]") {
+  for (int i = 0; i < sat::TOTAL_SCHEDULES; i++) {
+    sat::DecimationSchedule schedule = (sat::DecimationSchedule)i;
+    sat::DecimationSchedule parsed = sat::SCHEDULE_FIXED;
+    REQUIRE(sat::Solver::ParseSchedule(sat::Solver::ScheduleName(schedule),
+                                       parsed));
+    CHECK(parsed == schedule);
+  }
+
+  sat::DecimationSchedule parsed = sat::SCHEDULE_ADAPTIVE;
+  CHECK_FALSE(sat::Solver::ParseSchedule("unknown", parsed));
+  CHECK(parsed == sat::SCHEDULE_ADAPTIVE);
+};
+
+TEST_CASE("Solver - Adaptive decimation schedule", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(2000, 8600);
+
+  // Fixed schedule with the lower bound of the adaptive one
+  sat::Solver fixed(2000, 4.3, 7357);
+  REQUIRE(fixed.SID(graph, 0.0025) == sat::SAT);
+  REQUIRE(graph->IsSAT());
+
+  graph->Reset();
+  sat::Solver adaptive(2000, 4.3, 7357);
+  adaptive.schedule = sat::SCHEDULE_ADAPTIVE;
+  adaptive.minFraction = 0.0025;
+  REQUIRE(adaptive.SID(graph, 0.04) == sat::SAT);
+  REQUIRE(graph->IsSAT());
+
+  // Every round fixes between the bounds, except the last one (walksat)
+  CHECK(adaptive.totalAssignments >= 5 * (adaptive.totalSIDIterations - 1));
+  CHECK(adaptive.totalAssignments <= 80 * adaptive.totalSIDIterations);
+  CHECK(adaptive.totalSIDIterations < fixed.totalSIDIterations);
+  delete graph;
+};
@@ -0,0 +1,40 @@
+#include <catch2/catch.hpp>
+#include <iostream>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("Solver - Sweep order names", "[unit]") {
+  for (int i = 0; i < sat::TOTAL_SWEEP_ORDERS; i++) {
+    sat::SweepOrder order = (sat::SweepOrder)i;
+    sat::SweepOrder parsed = sat::SWEEP_SHUFFLE;
+    REQUIRE(sat::Solver::ParseSweepOrder(sat::Solver::SweepOrderName(order),
+                                         parsed));
+    CHECK(parsed == order);
+  }
+
+  sat::SweepOrder parsed = sat::SWEEP_BLOCK_SHUFFLE;
+  CHECK_FALSE(sat::Solver::ParseSweepOrder("unknown", parsed));
+  CHECK(parsed == sat::SWEEP_BLOCK_SHUFFLE);
+};
+
+TEST_CASE("Solver - SID with every sweep order", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(500, 1500);
+
+  for (int i = 0; i < sat::TOTAL_SWEEP_ORDERS; i++) {
+    sat::SweepOrder order = (sat::SweepOrder)i;
+    DYNAMIC_SECTION(sat::Solver::SweepOrderName(order)) {
+      graph->Reset();
+      sat::Solver solver(500, 3.0, 7357);
+      solver.sweepOrder = order;
+      solver.sweepBlockSize = 16;
+
+      REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+      REQUIRE(graph->IsSAT());
+    }
+  }
+  delete graph;
+};
@@ -0,0 +1,96 @@
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+#include <SubProducts.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("SubProducts - Fast log and exp", "[unit]") {
+  for (double x = 1.0e-16; x < 1.0e3; x *= 1.37) {
+    CHECK(sat::FastLog(x) == Approx(std::log(x)).epsilon(1e-9).margin(1e-12));
+  }
+  for (double x = -700.0; x < 5.0; x += 0.173) {
+    CHECK(sat::FastExp(x) == Approx(std::exp(x)).epsilon(1e-9));
+  }
+  CHECK(sat::FastExp(-1000.0) < 1.0e-300);
+};
+
+// Products of both arithmetics after the same updates, against the product of
+// the current surveys
+TEST_CASE("SubProducts - Log domain against linear products", "[unit]") {
+  std::mt19937 generator(7357);
+  std::uniform_real_distribution<double> distribution(0.0, 0.9);
+  std::vector<double> surveys(8);
+  double linear, log;
+  int linearZeros, logZeros;
+
+  sat::LinearSubProducts::Reset(linear, linearZeros);
+  sat::LogSubProducts::Reset(log, logZeros);
+  for (double& survey : surveys) {
+    survey = distribution(generator);
+    sat::LinearSubProducts::Add(linear, linearZeros, survey);
+    sat::LogSubProducts::Add(log, logZeros, survey);
+  }
+
+  for (int it = 0; it < 100000; it++) {
+    double& survey = surveys[it % surveys.size()];
+    // Some surveys of 1 every time
+    double newSurvey = it % 97 == 0 ? 1.0 : distribution(generator);
+    sat::LinearSubProducts::Update(linear, linearZeros, survey, newSurvey);
+    sat::LogSubProducts::Update(log, logZeros, survey, newSurvey);
+    survey = newSurvey;
+  }
+  CHECK(logZeros == 0);
+
+  double exact = 1.0;
+  for (double survey : surveys) exact *= 1.0 - survey;
+  CHECK(sat::LinearSubProducts::Product(linear, linearZeros) ==
+        Approx(exact).epsilon(1e-9).margin(1e-15));
+  CHECK(sat::LogSubProducts::Product(log, logZeros) ==
+        Approx(exact).epsilon(1e-9).margin(1e-15));
+
+  // Cavity products
+  for (unsigned i = 0; i < surveys.size(); i++) {
+    double without = 1.0;
+    for (unsigned j = 0; j < surveys.size(); j++) {
+      if (j != i) without *= 1.0 - surveys[j];
+    }
+    CHECK(sat::LinearSubProducts::Without(linear, linearZeros, surveys[i]) ==
+          Approx(without).epsilon(1e-9).margin(1e-15));
+    CHECK(sat::LogSubProducts::Without(log, logZeros, surveys[i]) ==
+          Approx(without).epsilon(1e-9).margin(1e-15));
+  }
+};
+
+TEST_CASE("SubProducts - Cavity of a survey of 1", "[unit]") {
+  double linear, log;
+  int linearZeros, logZeros;
+  sat::LinearSubProducts::Reset(linear, linearZeros);
+  sat::LogSubProducts::Reset(log, logZeros);
+  for (double survey : {0.5, 1.0, 0.25}) {
+    sat::LinearSubProducts::Add(linear, linearZeros, survey);
+    sat::LogSubProducts::Add(log, logZeros, survey);
+  }
+
+  CHECK(sat::LinearSubProducts::Product(linear, linearZeros) == 0.0);
+  CHECK(sat::LogSubProducts::Product(log, logZeros) < 1.0e-15);
+  CHECK(sat::LinearSubProducts::Without(linear, linearZeros, 1.0) ==
+        Approx(0.375));
+  CHECK(sat::LogSubProducts::Without(log, logZeros, 1.0) == Approx(0.375));
+  CHECK(sat::LinearSubProducts::Without(linear, linearZeros, 0.5) == 0.0);
+  CHECK(sat::LogSubProducts::Without(log, logZeros, 0.5) < 1.0e-15);
+};
+
+TEST_CASE("SubProducts - SID with the compiled arithmetic", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(2000, 8000);
+
+  sat::Solver solver(2000, 4.0, 7357);
+  REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+  REQUIRE(graph->IsSAT());
+  delete graph;
+};
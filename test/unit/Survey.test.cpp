@@ -0,0 +1,38 @@
+#include <catch2/catch.hpp>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+#include <Survey.hpp>
+
+#include "Helpers.hpp"
+
+TEST_CASE("Survey - Fixed point storage", "[unit]") {
+  for (double value = 0.0; value <= 1.0; value += 0.0123) {
+    sat::FixedSurvey survey = value;
+    CHECK((double)survey == Approx(value).margin(0.5 / 65535));
+  }
+  CHECK((double)sat::FixedSurvey(0.0) == 0.0);
+  CHECK((double)sat::FixedSurvey(1.0) == 1.0);
+  CHECK((double)sat::FixedSurvey(-0.5) == 0.0);
+  CHECK((double)sat::FixedSurvey(1.5) == 1.0);
+  CHECK(sizeof(sat::FixedSurvey) == 2);
+};
+
+TEST_CASE("Survey - Smaller edges with less precision", "[unit]") {
+  // 2 flags, the survey and 2 pointers are 32 bytes with a double survey
+  if (sizeof(sat::Survey) < sizeof(double)) CHECK(sizeof(sat::Edge) < 32);
+};
+
+TEST_CASE("Survey - SID with the compiled precision", "[unit]") {
+  sat::FactorGraph* graph = sat::test::PlantedGraph(2000, 8000);
+
+  sat::Solver solver(2000, 4.0, 7357);
+  REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+  REQUIRE(graph->IsSAT());
+  for (sat::Edge* edge : graph->edges) {
+    CHECK(edge->survey >= 0.0);
+    CHECK(edge->survey <= 1.0);
+  }
+  delete graph;
+};
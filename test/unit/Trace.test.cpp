@@ -0,0 +1,165 @@
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Project headders
+#include <FactorGraph.hpp>
+#include <Solver.hpp>
+#include <Trace.hpp>
+
+#include "Helpers.hpp"
+
+// Events of a trace as stored in the JSON file, one per line
+struct JSONEvent {
+  std::string name;
+  std::string phase;
+  double ts;
+  double dur;
+  std::string line;
+};
+
+static std::string field(const std::string& line, const std::string& key) {
+  std::string pattern = "\"" + key + "\": ";
+  size_t begin = line.find(pattern);
+  if (begin == std::string::npos) return "";
+  begin += pattern.size();
+  if (line[begin] == '"') {
+    return line.substr(begin + 1, line.find('"', begin + 1) - begin - 1);
+  }
+  return line.substr(begin, line.find_first_of(",}", begin) - begin);
+}
+
+static std::vector<JSONEvent> readJSON(const std::string& path,
+                                       std::string& text) {
+  std::ifstream file(path);
+  std::stringstream content;
+  content << file.rdbuf();
+  text = content.str();
+
+  std::vector<JSONEvent> events;
+  std::stringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.find("{\"name\"") != 0) continue;
+    std::string dur = field(line, "dur");
+    events.push_back({field(line, "name"), field(line, "ph"),
+                      std::stod(field(line, "ts")),
+                      dur.empty() ? -1.0 : std::stod(dur), line});
+  }
+  return events;
+}
+
+static bool contains(const JSONEvent& outer, const JSONEvent& inner) {
+  // The timestamps are stored with 3 decimals
+  return inner.ts >= outer.ts - 0.001 &&
+         inner.ts + std::max(inner.dur, 0.0) <=
+             outer.ts + outer.dur + 0.002;
+}
+
+TEST_CASE("Trace - Nested spans and counters in the JSON", "[unit]") {
+  std::string path = "./test/cnf/trace.json";
+  sat::Trace trace;
+  {
+    sat::TraceSpan outer(&trace, "outer");
+    outer.AddArg("depth", 1);
+    {
+      sat::TraceSpan inner(&trace, "inner");
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    trace.AddCounter("counter", {{"first", 1}, {"second", 2.5}});
+  }
+  REQUIRE(trace.storeJSON(path));
+
+  std::string text;
+  std::vector<JSONEvent> events = readJSON(path, text);
+  CHECK(text.find("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [") == 0);
+  CHECK(text.substr(text.size() - 4) == "\n]}\n");
+
+  // Spans are added when they finish
+  REQUIRE(events.size() == 3);
+  CHECK(events[0].name == "inner");
+  CHECK(events[0].phase == "X");
+  CHECK(events[0].dur >= 2000);
+  CHECK(events[1].name == "counter");
+  CHECK(events[1].phase == "C");
+  CHECK(events[1].dur < 0);
+  CHECK(events[1].line.find("\"args\": {\"first\": 1, \"second\": 2.5}") !=
+        std::string::npos);
+  CHECK(events[2].name == "outer");
+  CHECK(events[2].phase == "X");
+  CHECK(events[2].line.find("\"args\": {\"depth\": 1}") != std::string::npos);
+
+  CHECK(contains(events[2], events[0]));
+  CHECK(contains(events[2], events[1]));
+  CHECK(events[1].ts >= events[0].ts + events[0].dur - 0.001);
+  std::remove(path.c_str());
+};
+
+TEST_CASE("Trace - Clear removes the events and restarts the clock",
+          "[unit]") {
+  std::string path = "./test/cnf/trace.json";
+  sat::Trace trace;
+  {
+    sat::TraceSpan span(&trace, "span");
+  }
+  trace.AddCounter("counter", {{"value", 1}});
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  double before = trace.Now();
+  CHECK(trace.events.size() == 2);
+
+  trace.Clear();
+  CHECK(trace.events.empty());
+  CHECK(trace.Now() < before);
+
+  REQUIRE(trace.storeJSON(path));
+  std::string text;
+  CHECK(readJSON(path, text).empty());
+  CHECK(text == "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n]}\n");
+  std::remove(path.c_str());
+};
+
+TEST_CASE("Trace - SID", "[unit]") {
+  std::string path = "./test/cnf/trace.json";
+  sat::FactorGraph* graph = sat::test::PlantedGraph(1000, 4200);
+
+  sat::Trace trace;
+  sat::Solver solver(1000, 4.2, 7357);
+  solver.trace = &trace;
+  REQUIRE(solver.SID(graph, 0.01) == sat::SAT);
+  REQUIRE(trace.storeJSON(path));
+
+  std::string text;
+  std::vector<JSONEvent> events = readJSON(path, text);
+  std::vector<JSONEvent> rounds;
+  int spIterations = 0;
+  double lastUnassigned = 1000;
+  for (const JSONEvent& event : events) {
+    if (event.name == "SID round") rounds.push_back(event);
+    if (event.name != "SP iteration") continue;
+
+    // The SP iterations only see fewer unassigned variables in later rounds
+    spIterations++;
+    CHECK(event.phase == "C");
+    double unassigned = std::stod(field(event.line, "unassigned_variables"));
+    CHECK(unassigned <= lastUnassigned);
+    lastUnassigned = unassigned;
+  }
+  CHECK(spIterations == solver.totalSPIterations);
+  CHECK((int)rounds.size() == solver.totalSIDIterations);
+  CHECK(lastUnassigned < 1000);
+
+  // Every SP run is nested in a SID round
+  for (const JSONEvent& event : events) {
+    if (event.name != "SP") continue;
+    bool nested = false;
+    for (const JSONEvent& round : rounds) nested |= contains(round, event);
+    CHECK(nested);
+  }
+  std::remove(path.c_str());
+  delete graph;
+};
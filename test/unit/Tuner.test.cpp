@@ -0,0 +1,155 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Project headders
+#include <Generator.hpp>
+#include <Solver.hpp>
+#include <Tuner.hpp>
+
+TEST_CASE("Tuner - Store and load the solver options", "[unit]") {
+  std::string path = "./test/cnf/options.cfg";
+  sat::Solver solver(500, 4.0, 7357);
+  solver.sidFraction = 0.0123;
+  solver.spMaxIt = 321;
+  solver.spEpsilon = 0.00042;
+  solver.paramagneticState = 0.031;
+  solver.wsMaxTries = 3;
+  solver.wsMaxFlips = 12345;
+  solver.wsNoise = 0.42;
+  REQUIRE(solver.storeOptions(path));
+
+  sat::Solver loaded(500, 4.0, 7357);
+  REQUIRE(loaded.loadOptions(path));
+  CHECK(loaded.sidFraction == solver.sidFraction);
+  CHECK(loaded.spMaxIt == solver.spMaxIt);
+  CHECK(loaded.spEpsilon == solver.spEpsilon);
+  CHECK(loaded.paramagneticState == solver.paramagneticState);
+  CHECK(loaded.wsMaxTries == solver.wsMaxTries);
+  CHECK(loaded.wsMaxFlips == solver.wsMaxFlips);
+  CHECK(loaded.wsNoise == solver.wsNoise);
+
+  // Comments are skipped, unknown options and invalid values fail
+  {
+    std::ofstream file(path);
+    file << "# Tuned\n\nws-noise=0.3\n";
+  }
+  CHECK(loaded.loadOptions(path));
+  CHECK(loaded.wsNoise == 0.3);
+  {
+    std::ofstream file(path);
+    file << "ws-noise=1.5\n";
+  }
+  CHECK_FALSE(loaded.loadOptions(path));
+  {
+    std::ofstream file(path);
+    file << "sp-unknown=1\n";
+  }
+  CHECK_FALSE(loaded.loadOptions(path));
+  std::remove(path.c_str());
+  CHECK_FALSE(loaded.loadOptions(path));
+};
+
+TEST_CASE("Tuner - Successive halving of the candidates", "[unit]") {
+  sat::Generator generator(7357);
+  std::vector<std::string> instances;
+  for (int i = 0; i < 4; i++) {
+    std::vector<bool> solution;
+    instances.push_back("./test/cnf/tuner-" + std::to_string(i) + ".cnf");
+    std::ofstream file(instances.back());
+    generator.PlantedKSAT(file, 300, 1050, 3, solution);
+  }
+
+  sat::Tuner tuner(instances, 300, 3.5, 7357);
+  tuner.configs = 3;
+  tuner.threads = 2;
+  sat::TunerCandidate best =
+      tuner.Run([](sat::Solver& solver) { solver.wsMaxTries = 2; });
+
+  // 4 candidates: 1, 2 and 4 instances in 3 rounds
+  REQUIRE(tuner.candidates.size() == 4);
+  CHECK(tuner.candidates[0].rounds == 3);
+  CHECK(tuner.candidates[0].instances == 4);
+  CHECK(tuner.candidates[1].rounds == 2);
+  CHECK(tuner.candidates[1].instances == 2);
+  CHECK(tuner.candidates[3].rounds == 1);
+  CHECK(tuner.candidates[3].instances == 1);
+  CHECK(best.fraction == tuner.candidates[0].fraction);
+  CHECK(best.solved == 4);
+  for (const sat::TunerCandidate& candidate : tuner.candidates) {
+    CHECK(candidate.fraction >= tuner.minFraction);
+    CHECK(candidate.fraction <= std::max(tuner.maxFraction, 0.01));
+    CHECK(candidate.solved <= candidate.instances);
+  }
+
+  for (const std::string& path : instances) std::remove(path.c_str());
+};
+
+TEST_CASE("Tuner - Deadline of the candidates", "[unit]") {
+  sat::Generator generator(7357);
+  std::vector<std::string> instances;
+  for (int i = 0; i < 2; i++) {
+    std::vector<bool> solution;
+    instances.push_back("./test/cnf/tuner-" + std::to_string(i) + ".cnf");
+    std::ofstream file(instances.back());
+    generator.PlantedKSAT(file, 300, 1050, 3, solution);
+  }
+
+  // The deadline of the other candidates passes before SID starts
+  sat::Tuner tuner(instances, 300, 3.5, 7357);
+  tuner.configs = 3;
+  tuner.timeFactor = 0.0;
+  tuner.minSeconds = 1e-9;
+  sat::TunerCandidate best =
+      tuner.Run([](sat::Solver& solver) { solver.wsMaxTries = 2; });
+
+  REQUIRE(tuner.candidates.size() == 4);
+  CHECK(best.solved == 2);
+  CHECK(best.timeouts == 0);
+  for (unsigned c = 1; c < tuner.candidates.size(); c++) {
+    CHECK(tuner.candidates[c].solved == 0);
+    CHECK(tuner.candidates[c].timeouts == tuner.candidates[c].instances);
+  }
+
+  for (const std::string& path : instances) std::remove(path.c_str());
+};
+
+TEST_CASE("Tuner - Preprocessed instances", "[unit]") {
+  // The preprocessor finds the instance UNSAT, so SID never runs on it
+  sat::Generator generator(7357);
+  std::string path = "./test/cnf/tuner-0.cnf";
+  {
+    std::vector<bool> solution;
+    std::stringstream dimacs;
+    generator.PlantedKSAT(dimacs, 300, 1050, 3, solution);
+    std::string header;
+    std::getline(dimacs, header);
+    std::ofstream file(path);
+    file << "p cnf 300 1052\n" << dimacs.rdbuf() << "1 0\n-1 0\n";
+  }
+
+  sat::Tuner tuner({path}, 300, 3.5, 7357);
+  tuner.configs = 1;
+  tuner.preprocess = true;
+  tuner.variableElimination = true;
+  tuner.Run([](sat::Solver& solver) { solver.wsMaxTries = 2; });
+
+  REQUIRE(tuner.candidates.size() == 2);
+  for (const sat::TunerCandidate& candidate : tuner.candidates) {
+    CHECK(candidate.instances == 1);
+    CHECK(candidate.solved == 0);
+    CHECK(candidate.timeouts == 0);
+    CHECK(candidate.seconds == 0.0);
+  }
+
+  // Without preprocessing SID runs and finds no solution
+  tuner.preprocess = false;
+  tuner.Run([](sat::Solver& solver) { solver.wsMaxTries = 2; });
+  CHECK(tuner.candidates[0].solved == 0);
+  CHECK(tuner.candidates[0].seconds > 0.0);
+
+  std::remove(path.c_str());
+};